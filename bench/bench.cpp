@@ -0,0 +1,481 @@
+// File created by fob
+
+#include "../include/compiler.h"
+#include "../include/interpreter.h"
+#include "../include/jit.h"
+#include "../include/lexer.h"
+#include "../include/output.h"
+#include "../include/parser.h"
+#include "../include/profiler.h"
+#include "../include/program.h"
+#include "../include/source.h"
+#include "../include/vm.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define IEC_HAS_RUSAGE 1
+#endif
+
+// iec_bench times each phase of the language on a corpus of programs: the lexer (tokens/s),
+// the parser (nodes/s) and the execution on the interpreter, the VM and the JIT (statements/s,
+// counting the statements run by the interpreter). Every engine must print the same output as the
+// interpreter. The results are printed as a table or, with --json, as a JSON document.
+
+// Command line options
+struct Options {
+    std::vector<std::string> paths; // Programs to time (every .iec file of the corpus when empty)
+    bool json = false;              // Print the results as JSON
+    double minTime = 0.2;           // Minimum time spent repeating each measure, in seconds
+};
+
+// Time of a phase, the best of repeated runs
+struct Timing {
+    double seconds = 0; // Best time of a single run
+    int runs = 0;       // Number of runs
+};
+
+// Results of an engine on a program
+struct EngineResult {
+    const char *name;           // Name of the engine
+    bool available = false;     // Whether the engine can run on this machine
+    Timing timing{};            // Execution time
+    bool outputMatches = false; // Whether the output is the same as the interpreter output
+};
+
+// Results of a program
+struct ProgramResult {
+    std::string name;                   // Name of the program (file name without extension)
+    std::string error;                  // Why the program could not be timed (empty on success)
+    size_t tokens = 0;                  // Number of tokens
+    size_t nodes = 0;                   // Number of nodes built by the parser
+    size_t tokenBytes = 0;              // Memory held by the token buffer
+    size_t astBytes = 0;                // Memory of the arena holding the nodes built by the parser
+    long peakMemory = 0;                // Peak resident memory of the process after the program, in KB (0 when unknown)
+    uint64_t statements = 0;            // Number of statements executed by the interpreter
+    Timing lex;                         // Lexing time
+    Timing parse;                       // Parsing time
+    std::vector<EngineResult> engines;  // Execution times
+};
+
+// Stream buffer throwing away the text, so printing is timed without the cost of a terminal
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+// Parses the command line: iec_bench [--json] [--min-time=<seconds>] [<file>...]
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            try {
+                options.minTime = std::stod(arg.substr(11));
+            } catch (const std::exception &) {
+                throw std::runtime_error("Error: Invalid time " + arg.substr(11));
+            }
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::runtime_error("Error: Unknown option " + arg + "\nUsage: iec_bench [--json] [--min-time=<seconds>] [<file>...]");
+        } else {
+            options.paths.push_back(arg);
+        }
+    }
+
+    return options;
+}
+
+// Returns the .iec files of the corpus directory, sorted by name
+std::vector<std::string> corpus() {
+    std::vector<std::string> paths;
+
+    for (const auto &entry : std::filesystem::directory_iterator(IEC_BENCH_CORPUS)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".iec") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    return paths;
+}
+
+// Runs a phase at least three times and for at least minTime seconds, keeping the best time
+Timing measure(double minTime, const std::function<void()> &run) {
+    using Clock = std::chrono::steady_clock;
+
+    Timing timing;
+    double total = 0;
+
+    while (timing.runs < 3 || total < minTime) {
+        auto start = Clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (timing.runs == 0 || seconds < timing.seconds) {
+            timing.seconds = seconds;
+        }
+        total += seconds;
+        timing.runs++;
+    }
+
+    return timing;
+}
+
+// Returns the number of nodes of a syntax tree
+size_t countNodes(const Node *node) {
+    if (!node) {
+        return 0;
+    }
+
+    size_t count = 1;
+
+    switch (node->kind) {
+        case NodeKind::PROGRAM:
+            return count + countNodes(static_cast<const ProgramNode *>(node)->block);
+        case NodeKind::BLOCK: {
+            const auto *block = static_cast<const BlockNode *>(node);
+            return count + countNodes(block->decls) + countNodes(block->stmts);
+        }
+        case NodeKind::DECLS:
+            for (Node *decl : *static_cast<const DeclsNode *>(node)) {
+                count += countNodes(decl);
+            }
+            return count;
+        case NodeKind::STMTS:
+            for (Node *stmt : *static_cast<const StmtsNode *>(node)) {
+                count += countNodes(stmt);
+            }
+            return count;
+        case NodeKind::DECL:
+            return count + countNodes(static_cast<const DeclNode *>(node)->type);
+        case NodeKind::ARRAY_TYPE:
+            return count + countNodes(static_cast<const ArrayTypeNode *>(node)->type);
+        case NodeKind::ASSIGN: {
+            const auto *assign = static_cast<const AssignNode *>(node);
+            return count + countNodes(assign->loc) + countNodes(assign->expr);
+        }
+        case NodeKind::ARRAY_ACCESS:
+            return count + countNodes(static_cast<const ArrayAccessNode *>(node)->index);
+        case NodeKind::OR:
+            return count + countNodes(static_cast<const OrNode *>(node)->left) + countNodes(static_cast<const OrNode *>(node)->right);
+        case NodeKind::AND:
+            return count + countNodes(static_cast<const AndNode *>(node)->left) + countNodes(static_cast<const AndNode *>(node)->right);
+        case NodeKind::EQUALITY:
+            return count + countNodes(static_cast<const EqualityNode *>(node)->left) + countNodes(static_cast<const EqualityNode *>(node)->right);
+        case NodeKind::REL:
+            return count + countNodes(static_cast<const RelNode *>(node)->left) + countNodes(static_cast<const RelNode *>(node)->right);
+        case NodeKind::ADD:
+            return count + countNodes(static_cast<const AddNode *>(node)->left) + countNodes(static_cast<const AddNode *>(node)->right);
+        case NodeKind::MUL:
+            return count + countNodes(static_cast<const MulNode *>(node)->left) + countNodes(static_cast<const MulNode *>(node)->right);
+        case NodeKind::UNARY:
+            return count + countNodes(static_cast<const UnaryNode *>(node)->operand);
+        case NodeKind::FACTOR:
+            return count + countNodes(static_cast<const FactorNode *>(node)->loc);
+        case NodeKind::IF: {
+            const auto *ifNode = static_cast<const IfNode *>(node);
+            return count + countNodes(ifNode->condition) + countNodes(ifNode->ifStmt);
+        }
+        case NodeKind::IF_ELSE: {
+            const auto *ifElse = static_cast<const IfElseNode *>(node);
+            return count + countNodes(ifElse->condition) + countNodes(ifElse->ifStmt) + countNodes(ifElse->elseStmt);
+        }
+        case NodeKind::WHILE:
+            return count + countNodes(static_cast<const WhileNode *>(node)->condition) + countNodes(static_cast<const WhileNode *>(node)->body);
+        case NodeKind::DO_WHILE:
+            return count + countNodes(static_cast<const DoWhileNode *>(node)->body) + countNodes(static_cast<const DoWhileNode *>(node)->condition);
+        case NodeKind::PRINT:
+            return count + countNodes(static_cast<const PrintNode *>(node)->expr);
+        default:
+            return count;
+    }
+}
+
+// Runs a program once and returns its output, followed by the error that stopped it (if any)
+std::string capture(const std::function<void(OutputSink &)> &run) {
+    std::ostringstream text;
+    OutputSink output(text, OutputSink::FlushPolicy::EXIT);
+
+    try {
+        run(output);
+    } catch (const std::exception &e) {
+        output.flush();
+        text << e.what() << "\n";
+    }
+    output.flush();
+
+    return text.str();
+}
+
+// Returns the peak resident memory of the process in KB, or 0 when the system does not report it.
+// The peak never decreases, so it describes a program only when the smaller programs are run first.
+long peakMemory() {
+#ifdef IEC_HAS_RUSAGE
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+#endif
+
+    return 0;
+}
+
+// Times the phases of a single program
+ProgramResult benchmark(const std::string &path, double minTime) {
+    ProgramResult result;
+    result.name = std::filesystem::path(path).stem().string();
+
+    try {
+        SourceFile source(path);
+
+        // Lexing, with a new interner every time so each run interns all the identifiers
+        result.lex = measure(minTime, [&]() {
+            Interner interner;
+            Lexer lexer(source.text(), interner);
+            result.tokens = lexer.tokenize().size();
+        });
+
+        Interner interner;
+        Lexer lexer(source.text(), interner);
+        TokenBuffer tokens = lexer.tokenize();
+        result.tokenBytes = tokens.kinds.size() * sizeof(Lexer::Token) + tokens.values.size() * sizeof(int)
+                          + tokens.offsets.size() * sizeof(uint32_t) + tokens.newlines.size() * sizeof(uint32_t);
+
+        // Parsing, the nodes are counted on the tree built by the parser before any pass changes it
+        result.parse = measure(minTime, [&]() {
+            Parser parser(tokens);
+            parser.parse();
+        });
+
+        Parser parser(tokens);
+        Node *program = parser.parse();
+        result.nodes = countNodes(program);
+        result.astBytes = parser.getArena().bytesUsed();
+
+        Program::analyze(program, parser.getArena());
+
+        Compiler compiler;
+        Chunk chunk = compiler.compile(program);
+
+        // The interpreter output is the reference of the other engines, a program stopped by an error is not timed
+        std::ostringstream reference;
+        Profiler profiler;
+        {
+            OutputSink output(reference, OutputSink::FlushPolicy::EXIT);
+            Interpreter interpreter(output, &profiler);
+
+            interpreter.interpret(program);
+        }
+        result.statements = profiler.executed();
+
+        NullBuffer discardBuffer;
+        std::ostream discard(&discardBuffer);
+
+        // Interpreter
+        EngineResult interpreterResult{"interpreter"};
+        interpreterResult.available = true;
+        interpreterResult.outputMatches = capture([&](OutputSink &output) { Interpreter(output).interpret(program); }) == reference.str();
+        interpreterResult.timing = measure(minTime, [&]() {
+            OutputSink output(discard);
+            Interpreter interpreter(output);
+
+            interpreter.interpret(program);
+        });
+        result.engines.push_back(interpreterResult);
+
+        // VM
+        EngineResult vmResult{"vm"};
+        vmResult.available = true;
+        vmResult.outputMatches = capture([&](OutputSink &output) { VM(output).run(chunk); }) == reference.str();
+        vmResult.timing = measure(minTime, [&]() {
+            OutputSink output(discard);
+            VM vm(output);
+
+            vm.run(chunk);
+        });
+        result.engines.push_back(vmResult);
+
+        // JIT, the chunk is translated once so only the machine code is timed
+        EngineResult jitResult{"jit"};
+        JIT jit;
+        if (jit.compile(chunk)) {
+            jitResult.available = true;
+            jitResult.outputMatches = capture([&](OutputSink &output) { jit.run(output); }) == reference.str();
+            jitResult.timing = measure(minTime, [&]() {
+                OutputSink output(discard);
+
+                jit.run(output);
+            });
+        }
+        result.engines.push_back(jitResult);
+        result.peakMemory = peakMemory();
+    } catch (const std::exception &e) {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+// Returns the rate of a phase, or 0 when it was too fast to be measured
+double rate(double amount, const Timing &timing) {
+    return timing.seconds > 0 ? amount / timing.seconds : 0;
+}
+
+// Writes a string as a JSON string literal
+void writeJsonString(std::ostream &out, const std::string &text) {
+    out << '"';
+    for (char c : text) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int) c << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+
+// Writes the timing of a phase as a JSON object, with its rate under the given name
+void writeJsonTiming(std::ostream &out, const Timing &timing, const char *rateName, double amount) {
+    out << "{\"seconds\": " << timing.seconds << ", \"runs\": " << timing.runs
+        << ", \"" << rateName << "\": " << rate(amount, timing) << "}";
+}
+
+// Prints the results as a JSON document
+void printJson(std::ostream &out, const std::vector<ProgramResult> &results) {
+    out << std::setprecision(6);
+    out << "{\n  \"programs\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const ProgramResult &result = results[i];
+
+        out << (i ? ",\n" : "\n") << "    {\n      \"name\": ";
+        writeJsonString(out, result.name);
+
+        if (!result.error.empty()) {
+            out << ",\n      \"error\": ";
+            writeJsonString(out, result.error);
+            out << "\n    }";
+            continue;
+        }
+
+        out << ",\n      \"tokens\": " << result.tokens << ", \"nodes\": " << result.nodes << ", \"statements\": " << result.statements;
+        out << ",\n      \"memory\": {\"token_bytes\": " << result.tokenBytes << ", \"ast_bytes\": " << result.astBytes
+            << ", \"peak_rss_kb\": " << result.peakMemory << "}";
+        out << ",\n      \"lex\": ";
+        writeJsonTiming(out, result.lex, "tokens_per_second", (double) result.tokens);
+        out << ",\n      \"parse\": ";
+        writeJsonTiming(out, result.parse, "nodes_per_second", (double) result.nodes);
+        out << ",\n      \"execute\": {";
+
+        for (size_t j = 0; j < result.engines.size(); j++) {
+            const EngineResult &engine = result.engines[j];
+
+            out << (j ? ",\n" : "\n") << "        \"" << engine.name << "\": ";
+            if (!engine.available) {
+                out << "null";
+                continue;
+            }
+            out << "{\"seconds\": " << engine.timing.seconds << ", \"runs\": " << engine.timing.runs
+                << ", \"statements_per_second\": " << rate((double) result.statements, engine.timing)
+                << ", \"output_matches\": " << (engine.outputMatches ? "true" : "false") << "}";
+        }
+
+        out << "\n      }\n    }";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+// Prints the results as a table, rates in millions per second
+void printTable(std::ostream &out, const std::vector<ProgramResult> &results) {
+    out << std::left << std::setw(16) << "program" << std::right << std::setw(9) << "tokens" << std::setw(10) << "Mtok/s"
+        << std::setw(9) << "nodes" << std::setw(10) << "Mnode/s" << std::setw(10) << "AST KB" << std::setw(12) << "statements";
+    for (const char *engine : {"interpreter", "vm", "jit"}) {
+        out << std::setw(18) << (std::string(engine) + " Ms/s");
+    }
+    out << std::setw(10) << "peak MB" << "\n" << std::fixed;
+
+    for (const ProgramResult &result : results) {
+        out << std::left << std::setw(16) << result.name << std::right;
+
+        if (!result.error.empty()) {
+            out << " " << result.error << "\n";
+            continue;
+        }
+
+        out << std::setw(9) << result.tokens << std::setw(10) << std::setprecision(2) << rate((double) result.tokens, result.lex) / 1e6
+            << std::setw(9) << result.nodes << std::setw(10) << rate((double) result.nodes, result.parse) / 1e6
+            << std::setw(10) << std::setprecision(1) << (double) result.astBytes / 1024 << std::setw(12) << result.statements;
+
+        for (const EngineResult &engine : result.engines) {
+            std::string cell = "-";
+
+            if (engine.available) {
+                std::ostringstream value;
+                value << std::fixed << std::setprecision(2) << rate((double) result.statements, engine.timing) / 1e6;
+                cell = engine.outputMatches ? value.str() : value.str() + " (!)";
+            }
+            out << std::setw(18) << cell;
+        }
+        out << std::setw(10) << std::setprecision(1) << (double) result.peakMemory / 1024 << "\n";
+    }
+
+    out << std::defaultfloat;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+        std::vector<std::string> paths = options.paths.empty() ? corpus() : options.paths;
+        std::vector<ProgramResult> results;
+        bool failed = false;
+
+        for (const std::string &path : paths) {
+            results.push_back(benchmark(path, options.minTime));
+
+            const ProgramResult &result = results.back();
+            failed = failed || !result.error.empty();
+            for (const EngineResult &engine : result.engines) {
+                failed = failed || (engine.available && !engine.outputMatches);
+            }
+        }
+
+        if (options.json) {
+            printJson(std::cout, results);
+        } else {
+            printTable(std::cout, results);
+        }
+
+        return failed ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,578 @@
+// File created by fob
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// iec_gen writes a random program of tunable size, used to measure how the phases of the language
+// scale and to stress them with programs far bigger (or deeper) than the hand-written ones.
+// The programs are always valid: they type check, every variable is initialized before the first
+// statement that reads it, array indices are in bounds, divisors are non-zero literals, the values
+// never overflow and every loop runs a bounded number of times. The same options (and seed) always
+// produce the same program.
+
+// Command line options
+struct Options {
+    uint64_t seed = 1;          // Seed of the random choices
+    long statements = 1000;     // Number of statements to generate (approximate)
+    int depth = 4;              // Maximum nesting depth of the compound statements
+    int exprDepth = 3;          // Maximum depth of the expressions
+    int variables = 8;          // Number of scalar variables (a quarter of them boolean)
+    int arrays = 2;             // Number of arrays (a third of them boolean)
+    int arraySize = 100;        // Number of elements of each array
+    int trips = 4;              // Maximum number of iterations of a loop
+    long loopWork = 10000;      // Maximum product of the iterations of nested loops
+    std::string output;         // File receiving the program (standard output when empty)
+};
+
+// Generates a program in a single pass, writing the statements as they are chosen
+class Generator {
+public:
+    // Constructor: the stream must outlive the generator
+    Generator(const Options &options, std::ostream &out);
+
+    // Writes the whole program
+    void generate();
+
+private:
+    // Integer expression with a bound on its absolute value
+    struct IntExpr {
+        std::string text;   // Source of the expression
+        long long bound;    // The value is always in [-bound, bound]
+    };
+
+    static constexpr long long VALUE_BOUND = 999;       // Bound of the values stored in int variables
+    static constexpr long long EXPR_BOUND = 1000000;    // Bound of an int expression (shrunk by a division above it)
+    static constexpr long long PRODUCT_BOUND = 1000000000; // Bound of a product (before shrinking)
+    static constexpr long MAX_BODY = 32;                // Maximum number of statements of a nested body
+
+    const Options &options;
+    std::ostream &out;
+    uint64_t state;             // State of the random generator
+    int ints;                   // Number of int scalar variables
+    int bools;                  // Number of boolean scalar variables
+    int intArrays;              // Number of int arrays
+    int boolArrays;             // Number of boolean arrays
+    long remaining;             // Statements still to generate
+    int loops = 0;              // Loops enclosing the current statement
+    long long work = 1;         // Product of the iterations of the enclosing loops
+
+    // Returns the next random number (splitmix64, so the programs do not depend on the standard library)
+    uint64_t next();
+
+    // Returns a random number in [0, n)
+    int below(long long n);
+
+    // Writes the indentation of a nesting level
+    void indent(int level);
+
+    // Statements
+    void declarations();
+    void initializations();
+    void statementList(int level, long budget);
+    void statement(int level, long &budget);
+    void spine(int level);
+    void assignInt(int level);
+    void assignBool(int level);
+    void storeArray(int level);
+    void print(int level);
+    void ifStatement(int level, long &budget, bool withElse);
+    void loop(int level, long &budget, bool doWhile, int trips);
+    void block(int level, long &budget);
+    void breakStatement(int level);
+
+    // Opens and closes a loop counting with the counter of the loop depth, the body goes in between
+    void openLoop(int level, bool doWhile, int trips);
+    void closeLoop(int level, bool doWhile, int trips);
+
+    // Chooses the number of statements of a nested body
+    long bodyBudget(long &budget);
+
+    // Expressions
+    IntExpr intExpr(int depth);
+    IntExpr intLeaf();
+    std::string boolExpr(int depth);
+    std::string boolLeaf(int depth);
+    std::string index();
+
+    // Returns an expression equal to expr divided so that its value is within bound
+    static IntExpr shrink(IntExpr expr, long long bound);
+};
+
+// Parses the value of a numeric option, throws if it is not a number in [min, max]
+long long parseNumber(const std::string &arg, size_t prefix, long long min, long long max) {
+    std::string text = arg.substr(prefix);
+    size_t end = 0;
+    long long value;
+
+    try {
+        value = std::stoll(text, &end);
+    } catch (const std::exception &) {
+        end = 0;
+    }
+
+    if (end == 0 || end != text.size() || value < min || value > max) {
+        throw std::runtime_error("Error: Invalid value in " + arg + ", expected a number in [" + std::to_string(min) + ", " + std::to_string(max) + "]");
+    }
+
+    return value;
+}
+
+// Parses the command line: iec_gen [--seed=N] [--statements=N] [--depth=N] [--expr-depth=N] [--variables=N]
+// [--arrays=N] [--array-size=N] [--trips=N] [--loop-work=N] [--output=<file>]
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = (uint64_t) parseNumber(arg, 7, 0, INT64_MAX);
+        } else if (arg.rfind("--statements=", 0) == 0) {
+            options.statements = (long) parseNumber(arg, 13, 1, 100000000);
+        } else if (arg.rfind("--depth=", 0) == 0) {
+            options.depth = (int) parseNumber(arg, 8, 0, 1000000);
+        } else if (arg.rfind("--expr-depth=", 0) == 0) {
+            options.exprDepth = (int) parseNumber(arg, 13, 0, 64);
+        } else if (arg.rfind("--variables=", 0) == 0) {
+            options.variables = (int) parseNumber(arg, 12, 2, 1000000);
+        } else if (arg.rfind("--arrays=", 0) == 0) {
+            options.arrays = (int) parseNumber(arg, 9, 0, 1000000);
+        } else if (arg.rfind("--array-size=", 0) == 0) {
+            options.arraySize = (int) parseNumber(arg, 13, 1, 100000000);
+        } else if (arg.rfind("--trips=", 0) == 0) {
+            options.trips = (int) parseNumber(arg, 8, 1, 999);
+        } else if (arg.rfind("--loop-work=", 0) == 0) {
+            options.loopWork = (long) parseNumber(arg, 12, 1, 1000000000);
+        } else if (arg.rfind("--output=", 0) == 0) {
+            options.output = arg.substr(9);
+        } else {
+            throw std::runtime_error("Error: Unknown option " + arg + "\nUsage: iec_gen [--seed=N] [--statements=N] [--depth=N] [--expr-depth=N] "
+                                     "[--variables=N] [--arrays=N] [--array-size=N] [--trips=N] [--loop-work=N] [--output=<file>]");
+        }
+    }
+
+    return options;
+}
+
+// Constructor: splits the variables between the two types
+Generator::Generator(const Options &options, std::ostream &out) : options(options), out(out), state(options.seed) {
+    bools = std::max(1, options.variables / 4);
+    ints = options.variables - bools;
+    boolArrays = options.arrays / 3;
+    intArrays = options.arrays - boolArrays;
+    remaining = options.statements;
+}
+
+uint64_t Generator::next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+}
+
+int Generator::below(long long n) {
+    return (int) (next() % (uint64_t) n);
+}
+
+// Deep programs keep a bounded indentation, so the size of the source stays linear in the statements
+void Generator::indent(int level) {
+    out << std::string((size_t) std::min(level, 16) * 4, ' ');
+}
+
+// Writes the program: the declarations, the initializations, a spine of nested statements reaching
+// the maximum depth and then random statements until the budget is spent
+void Generator::generate() {
+    out << "{\n";
+    declarations();
+    initializations();
+    spine(1);
+    statementList(1, remaining);
+    out << "}\n";
+}
+
+// Declares the scalars (v int, b boolean), the arrays (a int, f boolean) and a loop counter c per nesting level
+void Generator::declarations() {
+    for (int i = 0; i < ints; i++) {
+        out << "    int v" << i << ";\n";
+    }
+    for (int i = 0; i < bools; i++) {
+        out << "    boolean b" << i << ";\n";
+    }
+    for (int i = 0; i < intArrays; i++) {
+        out << "    int[" << options.arraySize << "] a" << i << ";\n";
+    }
+    for (int i = 0; i < boolArrays; i++) {
+        out << "    boolean[" << options.arraySize << "] f" << i << ";\n";
+    }
+    for (int i = 0; i <= options.depth; i++) {
+        out << "    int c" << i << ";\n";
+    }
+}
+
+// Initializes every variable, the arrays with a loop over their elements (the counters last, as c0 runs the loops)
+void Generator::initializations() {
+    for (int i = 0; i < ints; i++) {
+        out << "    v" << i << " = " << below(VALUE_BOUND + 1) << ";\n";
+    }
+    for (int i = 0; i < bools; i++) {
+        out << "    b" << i << " = " << (below(2) ? "true" : "false") << ";\n";
+    }
+    for (int i = 0; i < intArrays + boolArrays; i++) {
+        out << "    c0 = 0;\n";
+        out << "    while (c0 < " << options.arraySize << ") {\n";
+        if (i < intArrays) {
+            out << "        a" << i << "[c0] = c0 - c0 / " << VALUE_BOUND + 1 << " * " << VALUE_BOUND + 1 << ";\n";
+        } else {
+            out << "        f" << i - intArrays << "[c0] = c0 / " << i + 2 << " * " << i + 2 << " == c0;\n";
+        }
+        out << "        c0 = c0 + 1;\n";
+        out << "    }\n";
+    }
+    for (int i = 0; i <= options.depth; i++) {
+        out << "    c" << i << " = 0;\n";
+    }
+}
+
+// Writes statements until budget of them have been generated (or the program budget is spent)
+void Generator::statementList(int level, long budget) {
+    while (budget > 0 && remaining > 0) {
+        statement(level, budget);
+    }
+}
+
+// Writes a random statement, compound statements take part of the budget for their bodies
+void Generator::statement(int level, long &budget) {
+    bool compound = level <= options.depth && budget >= 3;
+    int choice = below(compound ? 100 : 60);
+
+    budget--;
+    remaining--;
+
+    if (choice < 5 && loops > 0) {
+        breakStatement(level);
+    } else if (choice < 30) {
+        assignInt(level);
+    } else if (choice < 40) {
+        assignBool(level);
+    } else if (choice < 55) {
+        if (intArrays + boolArrays > 0) {
+            storeArray(level);
+        } else {
+            assignInt(level);
+        }
+    } else if (choice < 60) {
+        print(level);
+    } else if (choice < 70) {
+        ifStatement(level, budget, false);
+    } else if (choice < 78) {
+        ifStatement(level, budget, true);
+    } else if (choice < 96) {
+        int trips = 1 + below(options.trips);
+
+        if (work * trips <= options.loopWork) {
+            loop(level, budget, choice >= 90, trips);
+        } else {
+            ifStatement(level, budget, false);
+        }
+    } else {
+        block(level, budget);
+    }
+}
+
+// Writes a chain of nested compound statements down to the maximum depth, each with a few statements
+// of its own, so the deepest nesting is always reached. It is written iteratively (opening all the
+// statements, then closing them) so the generator itself handles any depth.
+void Generator::spine(int level) {
+    struct Open {
+        int kind;   // 0 if, 1 while, 2 do-while, 3 block
+        int trips;  // Iterations of a loop
+    };
+
+    std::vector<Open> opened;
+
+    for (int depth = level; depth <= options.depth && remaining >= 4; depth++) {
+        int trips = 1 + below(options.trips);
+        int kind = below(4);
+
+        if ((kind == 1 || kind == 2) && work * trips > options.loopWork) {
+            kind = 0;
+        }
+
+        remaining--;
+        if (kind == 0) {
+            indent(depth);
+            out << "if (" << boolExpr(options.exprDepth) << ") {\n";
+        } else if (kind == 3) {
+            indent(depth);
+            out << "{\n";
+        } else {
+            openLoop(depth, kind == 2, trips);
+        }
+        opened.push_back(Open{kind, trips});
+
+        long budget = 2;
+        statementList(depth + 1, budget);
+    }
+
+    for (int depth = level + (int) opened.size() - 1; depth >= level; depth--) {
+        const Open &open = opened.back();
+
+        if (open.kind == 1 || open.kind == 2) {
+            closeLoop(depth, open.kind == 2, open.trips);
+        } else {
+            indent(depth);
+            out << "}\n";
+        }
+        opened.pop_back();
+    }
+}
+
+// v = <int expr>;
+void Generator::assignInt(int level) {
+    indent(level);
+    out << "v" << below(ints) << " = " << shrink(intExpr(options.exprDepth), VALUE_BOUND).text << ";\n";
+}
+
+// b = <bool expr>;
+void Generator::assignBool(int level) {
+    indent(level);
+    out << "b" << below(bools) << " = " << boolExpr(options.exprDepth) << ";\n";
+}
+
+// a[<index>] = <int expr>; or f[<index>] = <bool expr>;
+void Generator::storeArray(int level) {
+    int array = below(intArrays + boolArrays);
+
+    indent(level);
+    if (array < intArrays) {
+        out << "a" << array << "[" << index() << "] = " << shrink(intExpr(options.exprDepth), VALUE_BOUND).text << ";\n";
+    } else {
+        out << "f" << array - intArrays << "[" << index() << "] = " << boolExpr(options.exprDepth) << ";\n";
+    }
+}
+
+// print(<expr>);
+void Generator::print(int level) {
+    indent(level);
+    out << "print(" << (below(2) ? intExpr(options.exprDepth).text : boolExpr(options.exprDepth)) << ");\n";
+}
+
+// if (<bool expr>) { ... } [else { ... }]
+void Generator::ifStatement(int level, long &budget, bool withElse) {
+    indent(level);
+    out << "if (" << boolExpr(options.exprDepth) << ") {\n";
+    statementList(level + 1, bodyBudget(budget));
+
+    if (withElse) {
+        indent(level);
+        out << "} else {\n";
+        statementList(level + 1, bodyBudget(budget));
+    }
+
+    indent(level);
+    out << "}\n";
+}
+
+// A loop running trips times, counting with the counter of its loop depth
+void Generator::loop(int level, long &budget, bool doWhile, int trips) {
+    long body = bodyBudget(budget);
+
+    openLoop(level, doWhile, trips);
+    statementList(level + 1, body);
+    closeLoop(level, doWhile, trips);
+}
+
+// { ... }
+void Generator::block(int level, long &budget) {
+    indent(level);
+    out << "{\n";
+    statementList(level + 1, bodyBudget(budget));
+    indent(level);
+    out << "}\n";
+}
+
+// if (<bool expr>) break;
+void Generator::breakStatement(int level) {
+    indent(level);
+    out << "if (" << boolExpr(options.exprDepth) << ") break;\n";
+}
+
+// The counter is reset before the loop and incremented at the end of its body, the statements of the
+// body never assign it (nested loops use the counters of the deeper loop depths)
+void Generator::openLoop(int level, bool doWhile, int trips) {
+    indent(level);
+    out << "c" << loops << " = 0;\n";
+    indent(level);
+    if (doWhile) {
+        out << "do {\n";
+    } else {
+        out << "while (c" << loops << " < " << trips << ") {\n";
+    }
+
+    loops++;
+    work *= trips;
+}
+
+void Generator::closeLoop(int level, bool doWhile, int trips) {
+    loops--;
+    work /= trips;
+
+    indent(level + 1);
+    out << "c" << loops << " = c" << loops << " + 1;\n";
+    indent(level);
+    if (doWhile) {
+        out << "} while (c" << loops << " < " << trips << ");\n";
+    } else {
+        out << "}\n";
+    }
+}
+
+// Gives a nested body a random share of the remaining budget, at most half of it and at most
+// MAX_BODY statements: big programs get long statement lists instead of a few huge bodies
+// that a false condition would skip entirely
+long Generator::bodyBudget(long &budget) {
+    long body = budget > 1 ? 1 + below(std::min(MAX_BODY, std::max(1L, budget / 2))) : 1;
+
+    budget = std::max(0L, budget - body);
+
+    return body;
+}
+
+// Returns a random int expression, keeping track of its bound so no operation can overflow
+Generator::IntExpr Generator::intExpr(int depth) {
+    if (depth == 0 || below(3) == 0) {
+        return intLeaf();
+    }
+
+    IntExpr left = intExpr(depth - 1);
+
+    switch (below(5)) {
+        case 0:
+            return shrink(IntExpr{"-(" + left.text + ")", left.bound}, EXPR_BOUND);
+        case 1: {
+            int divisor = 1 + below(9);
+            return IntExpr{"(" + left.text + " / " + std::to_string(divisor) + ")", left.bound / divisor};
+        }
+        case 2: {
+            IntExpr right = intExpr(depth - 1);
+
+            if (left.bound * right.bound <= PRODUCT_BOUND) {
+                return shrink(IntExpr{"(" + left.text + " * " + right.text + ")", left.bound * right.bound}, EXPR_BOUND);
+            }
+
+            return shrink(IntExpr{"(" + left.text + " + " + right.text + ")", left.bound + right.bound}, EXPR_BOUND);
+        }
+        default: {
+            IntExpr right = intExpr(depth - 1);
+            const char *op = below(2) ? " + " : " - ";
+
+            return shrink(IntExpr{"(" + left.text + op + right.text + ")", left.bound + right.bound}, EXPR_BOUND);
+        }
+    }
+}
+
+// Returns a literal, an int scalar, a loop counter or an element of an int array
+Generator::IntExpr Generator::intLeaf() {
+    switch (below(intArrays > 0 ? 4 : 3)) {
+        case 0:
+            return IntExpr{std::to_string(below(VALUE_BOUND + 1)), VALUE_BOUND};
+        case 1:
+            return IntExpr{"v" + std::to_string(below(ints)), VALUE_BOUND};
+        case 2:
+            // A counter is at most trips (after its last increment), or zero outside its loop
+            return IntExpr{"c" + std::to_string(below(options.depth + 1)), options.trips};
+        default:
+            return IntExpr{"a" + std::to_string(below(intArrays)) + "[" + index() + "]", VALUE_BOUND};
+    }
+}
+
+// Returns a random boolean expression
+std::string Generator::boolExpr(int depth) {
+    if (depth == 0 || below(3) == 0) {
+        return boolLeaf(depth);
+    }
+
+    switch (below(4)) {
+        case 0:
+            return "!(" + boolExpr(depth - 1) + ")";
+        case 1:
+            return "(" + boolExpr(depth - 1) + " && " + boolExpr(depth - 1) + ")";
+        case 2:
+            return "(" + boolExpr(depth - 1) + " || " + boolExpr(depth - 1) + ")";
+        default:
+            return "(" + boolExpr(depth - 1) + (below(2) ? " == " : " != ") + boolExpr(depth - 1) + ")";
+    }
+}
+
+// Returns a literal, a boolean scalar, an element of a boolean array or a comparison of int expressions
+std::string Generator::boolLeaf(int depth) {
+    static const char *const comparisons[] = {" < ", " <= ", " > ", " >= ", " == ", " != "};
+
+    switch (below(boolArrays > 0 ? 5 : 4)) {
+        case 0:
+            return below(2) ? "true" : "false";
+        case 1:
+            return "b" + std::to_string(below(bools));
+        case 2:
+        case 3:
+            return "(" + intExpr(std::max(0, depth - 1)).text + comparisons[below(6)] + intExpr(std::max(0, depth - 1)).text + ")";
+        default:
+            return "f" + std::to_string(below(boolArrays)) + "[" + index() + "]";
+    }
+}
+
+// Returns an index in [0, arraySize): a literal, the counter of an enclosing loop when its values fit,
+// or an int scalar (in [-999, 999]) shifted and scaled into the array
+std::string Generator::index() {
+    switch (below(3)) {
+        case 0:
+            return std::to_string(below(options.arraySize));
+        case 1:
+            if (loops > 0 && options.trips <= options.arraySize) {
+                return "c" + std::to_string(below(loops));
+            }
+            return std::to_string(below(options.arraySize));
+        default: {
+            long long divisor = 2 * VALUE_BOUND / options.arraySize + 1;
+            return "(v" + std::to_string(below(ints)) + " + " + std::to_string(VALUE_BOUND) + ") / " + std::to_string(divisor);
+        }
+    }
+}
+
+Generator::IntExpr Generator::shrink(IntExpr expr, long long bound) {
+    if (expr.bound <= bound) {
+        return expr;
+    }
+
+    long long divisor = expr.bound / (bound + 1) + 1;
+
+    return IntExpr{"(" + expr.text + ") / " + std::to_string(divisor), expr.bound / divisor};
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+
+        if (options.output.empty()) {
+            Generator(options, std::cout).generate();
+        } else {
+            std::ofstream file(options.output);
+
+            if (!file) {
+                throw std::runtime_error("Error: Unable to open file " + options.output);
+            }
+            Generator(options, file).generate();
+        }
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
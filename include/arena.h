@@ -0,0 +1,77 @@
+// File created by fob
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The Arena is a bump allocator: objects are placed one after the other inside large blocks
+// and are all released together when the arena is cleared or destroyed.
+// It is used by the Parser to allocate the AST nodes contiguously in parse order.
+class Arena {
+public:
+    // Constructor: blockSize is the size of each memory block requested to the system
+    explicit Arena(size_t blockSize = 64 * 1024);
+
+    // Destructor: releases every object allocated in the arena
+    ~Arena();
+
+    // Arenas own their memory, so they can be moved but not copied
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    Arena(Arena &&other) noexcept;
+    Arena &operator=(Arena &&other) noexcept;
+
+    // Constructs a T inside the arena, its destructor (if any) runs when the arena is cleared
+    template <typename T, typename... Args>
+    T *make(Args &&... args) {
+        T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            finalizers.push_back({object, [](void *pointer) { static_cast<T *>(pointer)->~T(); }});
+        }
+
+        return object;
+    }
+
+    // Copies count trivially copyable elements into a contiguous array inside the arena
+    template <typename T>
+    T *copyArray(const T *source, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "arena arrays hold trivially copyable elements");
+
+        T *array = static_cast<T *>(allocate(sizeof(T) * count, alignof(T)));
+        std::uninitialized_copy(source, source + count, array);
+
+        return array;
+    }
+
+    // Returns uninitialized memory with the requested size and alignment
+    void *allocate(size_t size, size_t alignment);
+
+    // Destroys all the objects and releases all the memory with a single operation
+    void clear();
+
+    // Returns the number of bytes handed out by the arena
+    size_t bytesUsed() const;
+
+private:
+    // Destructor call registered for a non trivially destructible object
+    struct Finalizer {
+        void *object;               // Object to destroy
+        void (*destroy)(void *);    // Function calling the destructor of the object
+    };
+
+    size_t blockSize;                           // Default size of each block
+    std::vector<std::unique_ptr<char[]>> blocks; // Memory blocks owned by the arena
+    char *current = nullptr;                    // Next free byte of the current block
+    size_t remaining = 0;                       // Free bytes left in the current block
+    size_t used = 0;                            // Bytes handed out so far
+    std::vector<Finalizer> finalizers;          // Destructors to run on clear
+};
+
+#endif // ARENA_H
@@ -1,409 +1,632 @@
-// File created by fob
-#ifndef AST_H
-#define AST_H
-
-#include "lexer.h"
-
-#include <string>
-#include <iostream>
-
-// The AST is the abstract syntax tree
-
-// Base class for syntax tree nodes
-class Node {
-    public:
-        // Position variables
-        int line;
-        int column;
-
-        // Constructor
-        Node(Lexer &lexer) {
-            line = lexer.getLine();
-            column = lexer.getColumn();
-        }
-
-        virtual ~Node() = default; // Destructor
-
-        // Virtual function to override the printing for each node
-        virtual void print(std::ostream& out, int indent = 0) const = 0;
-};
-
-// Program Node
-class ProgramNode : public Node {
-    public:
-        Node* block; // Block
-
-        ProgramNode(Lexer &lexer, Node* block) : Node(lexer), block(block) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "ProgramNode\n";
-            block->print(out, indent + 2);
-        }
-};
-
-// Block Node
-class BlockNode : public Node {
-    public:
-        // Child nodes
-        Node* decls; // Declarations
-        Node* stmts; // Statements
-
-        BlockNode(Lexer &lexer, Node* decls, Node* stmts) : Node(lexer), decls(decls), stmts(stmts) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "BlockNode\n";
-            if (decls) decls->print(out, indent + 2);
-            if (stmts) stmts->print(out, indent + 2);
-        }
-};
-
-// Declarations Node
-class DeclsNode : public Node {
-    public:
-        // Child nodes
-        Node* decl; // Declaration
-        Node* next; // Next declarations
-
-        DeclsNode(Lexer &lexer, Node* decl, Node* next) : Node(lexer), decl(decl), next(next) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "DeclsNode\n";
-            if (decl) decl->print(out, indent + 2);
-            if (next) next->print(out, indent + 2);
-        }
-};
-
-// Statements Node
-class StmtsNode : public Node {
-    public:
-        // Child nodes
-        Node* stmt; // Statement
-        Node* next; // Next statements
-
-        StmtsNode(Lexer &lexer, Node* stmt, Node* next) : Node(lexer), stmt(stmt), next(next) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "StmtsNode\n";
-            if (stmt) stmt->print(out, indent + 2);
-            if (next) next->print(out, indent + 2);
-        }
-};
-
-// Declaration Node
-class DeclNode : public Node {
-    public:
-        // Child nodes
-        Node* type;       // Basic Type or Array Type
-        std::string id;   // Identifier
-
-        DeclNode(Lexer &lexer, Node* type, std::string id) : Node(lexer), type(type), id(id) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "DeclNode: " << id << "\n";
-            type->print(out, indent + 2);
-        }
-};
-
-// Basic Type Node
-class BasicTypeNode : public Node {
-    public:
-        std::string typeName; // Type name
-
-        BasicTypeNode(Lexer &lexer, std::string typeName) : Node(lexer), typeName(typeName) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "BasicTypeNode: " << typeName << "\n";
-        }
-};
-
-// Array Type Node
-class ArrayTypeNode : public Node {
-    public:
-        Node* type;     // Basic type
-        int arraySize;  // Array size
-
-        ArrayTypeNode(Lexer &lexer, Node* type, int arraySize) : Node(lexer), type(type), arraySize(arraySize) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "ArrayTypeNode: size = " << arraySize << "\n";
-            type->print(out, indent + 2);
-        }
-};
-
-// Identifier Node
-class IdNode : public Node {
-    public:
-        std::string id; // Identifier
-
-        IdNode(Lexer &lexer, std::string id) : Node(lexer), id(id) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "IdNode: " << id << "\n";
-        }
-};
-
-// Assignment Node
-class AssignNode : public Node {
-    public:
-        // Child nodes
-        Node* loc;      // Locator
-        Node* expr;     // Expression
-
-        AssignNode(Lexer &lexer, Node* loc, Node* expr) : Node(lexer), loc(loc), expr(expr) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "AssignNode\n";
-            loc->print(out, indent + 2);
-            expr->print(out, indent + 2);
-        }
-};
-
-// Array Access Node
-class ArrayAccessNode : public Node {
-    public:
-        Node* index;    // Expression
-        std::string id; // Identifier
-
-        ArrayAccessNode(Lexer &lexer, Node* index, std::string id) : Node(lexer), index(index), id(id) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "ArrayAccessNode: " << id << "\n";
-            index->print(out, indent + 2);
-        }
-};
-
-// Or Node
-class OrNode : public Node {
-    public:
-        // Child nodes
-        Node* left;  // Left operand
-        Node* right; // Right operand
-
-        OrNode(Lexer &lexer, Node* left, Node* right) : Node(lexer), left(left), right(right) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "OrNode\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// And Node
-class AndNode : public Node {
-    public:
-        // Child nodes
-        Node* left;  // Left operand
-        Node* right; // Right operand
-
-        AndNode(Lexer &lexer, Node* left, Node* right) : Node(lexer), left(left), right(right) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "AndNode\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// Equality Node (== and !=)
-class EqualityNode : public Node {
-    public:
-        // Child nodes
-        Node* left;    // Left operand
-        Node* right;   // Right operand
-        bool isEqual;  // Type identifier (true for '==' and false for '!=')
-
-        EqualityNode(Lexer &lexer, Node* left, Node* right, bool isEqual) : Node(lexer), left(left), right(right), isEqual(isEqual) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "EqualityNode: " << (isEqual ? "==" : "!=") << "\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// Relational Node (<, <=, >, >=)
-class RelNode : public Node {
-    public:
-        enum Op { LESS, LESSEQ, GREATER, GREATEREQ }; // Operations
-        // Child nodes
-        Node* left;     // Left operand
-        Node* right;    // Right operand
-        Op op;          // Operation type
-
-        RelNode(Lexer &lexer, Node* left, Node* right, Op op) : Node(lexer), left(left), right(right), op(op) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            static const char* opNames[] = { "<", "<=", ">", ">=" };
-            out << std::string(indent, ' ') << "RelNode: " << opNames[op] << "\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// Addition and Subtraction Node (+, -)
-class AddNode : public Node {
-    public:
-        // Child nodes
-        Node* left;         // Left operand
-        Node* right;        // Right operand
-        bool isAddition;    // Type identifier (true for '+' false for '-')
-
-        AddNode(Lexer &lexer, Node* left, Node* right, bool isAddition) : Node(lexer), left(left), right(right), isAddition(isAddition) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "AddNode: " << (isAddition ? "+" : "-") << "\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// Multiplication and Division Node (*, /)
-class MulNode : public Node {
-    public:
-        // Child nodes
-        Node* left;             // Left operand
-        Node* right;            // Right operand
-        bool isMultiplication;  // Type identifier (true for '*' false for '/')
-
-        MulNode(Lexer &lexer, Node* left, Node* right, bool isMultiplication) : Node(lexer), left(left), right(right), isMultiplication(isMultiplication) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "MulNode: " << (isMultiplication ? "*" : "/") << "\n";
-            left->print(out, indent + 2);
-            right->print(out, indent + 2);
-        }
-};
-
-// Unary Operations Node (!, -)
-class UnaryNode : public Node {
-    public:
-        enum Op { NOT, NEG }; // Operations
-        Node* operand;        // Operand
-        Op op;                // Operation type
-
-        UnaryNode(Lexer &lexer, Node* operand, Op op) : Node(lexer), operand(operand), op(op) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "UnaryNode: " << (op == NOT ? "!" : "-") << "\n";
-            operand->print(out, indent + 2);
-        }
-};
-
-// Factor Node (INT, BOOL, ID, LOC)
-class FactorNode : public Node {
-    public:
-        enum Type { BOOL, INT, ID }; // Types
-        Node* loc;          // Locator node
-        int intValue;       // Value if INT
-        bool boolValue;     // Value if BOOL
-        Type type;          // Type
-
-        FactorNode(Lexer &lexer, Type type, int intValue = 0, bool boolValue = false, Node* loc = nullptr)
-            : Node(lexer), type(type), intValue(intValue), boolValue(boolValue), loc(loc) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "FactorNode: ";
-            switch(type) {
-                case BOOL: out << "bool = " << (boolValue ? "true" : "false") << "\n"; break;
-                case INT: out << "int = " << intValue << "\n"; break;
-                case ID: loc->print(out, indent + 2); break;
-            }
-        }
-};
-
-// If Node
-class IfNode : public Node {
-    public:
-        // Child nodes
-        Node* condition; // Condition
-        Node* ifStmt;    // If statement
-
-        IfNode(Lexer &lexer, Node* condition, Node* ifStmt) : Node(lexer), condition(condition), ifStmt(ifStmt) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "IfNode\n";
-            condition->print(out, indent + 2);
-            ifStmt->print(out, indent + 2);
-        }
-};
-
-// If Else Node
-class IfElseNode : public Node {
-    public:
-        // Child nodes
-        Node* condition; // Condition
-        Node* ifStmt;    // If statement
-        Node* elseStmt;  // Else statement
-
-        IfElseNode(Lexer &lexer, Node* condition, Node* ifStmt, Node* elseStmt) : Node(lexer), condition(condition), ifStmt(ifStmt), elseStmt(elseStmt) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "IfElseNode\n";
-            condition->print(out, indent + 2);
-            ifStmt->print(out, indent + 2);
-            elseStmt->print(out, indent + 2);
-        }
-};
-
-// While Node
-class WhileNode : public Node {
-    public:
-        // Child nodes
-        Node* condition; // Condition
-        Node* body;      // Body
-
-        WhileNode(Lexer &lexer, Node* condition, Node* body) : Node(lexer), condition(condition), body(body) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "WhileNode\n";
-            condition->print(out, indent + 2);
-            body->print(out, indent + 2);
-        }
-};
-
-// Do While Node
-class DoWhileNode : public Node {
-    public:
-        // Child nodes
-        Node* condition; // Condition
-        Node* body;      // Body
-
-        DoWhileNode(Lexer &lexer, Node* body, Node* condition) : Node(lexer), body(body), condition(condition) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "DoWhileNode\n";
-            body->print(out, indent + 2);
-            condition->print(out, indent + 2);
-        }
-};
-
-// Print Node
-class PrintNode : public Node {
-    public:
-        Node* expr; // Expression
-
-        PrintNode(Lexer &lexer, Node* expr) : Node(lexer), expr(expr) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "PrintNode\n";
-            expr->print(out, indent + 2);
-        }
-};
-
-// Break Node
-class BreakNode : public Node {
-    public:
-        BreakNode(Lexer &lexer) : Node(lexer) {} // Constructor
-
-        void print(std::ostream& out, int indent = 0) const override {
-            out << std::string(indent, ' ') << "BreakNode\n";
-        }
-};
-
-// Helper function to handle the printing of the AST
-inline std::ostream& operator<<(std::ostream& out, const Node& node) {
-    node.print(out);
-    return out;
-}
-
-#endif // AST_H
+// File created by fob
+#ifndef AST_H
+#define AST_H
+
+#include "lexer.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <iostream>
+#include <vector>
+
+// The AST is the abstract syntax tree
+
+class VectorLoop; // Elementwise kernel of a counted loop (see vectorloop.h)
+
+// Kinds of syntax tree nodes, one for each Node subclass
+enum class NodeKind : uint8_t {
+    PROGRAM, BLOCK, DECLS, STMTS, DECL, BASIC_TYPE, ARRAY_TYPE, ID, ASSIGN, ARRAY_ACCESS,
+    OR, AND, EQUALITY, REL, ADD, MUL, UNARY, FACTOR, IF, IF_ELSE, WHILE, DO_WHILE, PRINT, BREAK
+};
+
+// Static type of the value produced by an expression
+enum class ValueType : uint8_t {
+    UNKNOWN, // Not checked yet (or not an expression)
+    INT,     // Integer value
+    BOOL     // Boolean value
+};
+
+// Base class for syntax tree nodes
+// Nodes carry their kind so passes can dispatch with a single switch instead of RTTI
+class Node {
+    public:
+        NodeKind kind;                              // Node kind
+        ValueType valueType = ValueType::UNKNOWN;   // Type of an expression (filled by the TypeChecker)
+
+        // Position variables: the position reached after the node, used by error messages
+        int line;
+        int column;
+        int startLine; // Line of the first token of a statement (set by the parser, the profiler reports it)
+
+        // Constructor
+        Node(NodeKind kind, Position position) : kind(kind) {
+            line = position.line;
+            column = position.column;
+            startLine = position.line;
+        }
+
+        // Prints the node, dispatching on its kind to the subclass implementation
+        void print(std::ostream& out, int indent = 0) const;
+};
+
+// Program Node
+class ProgramNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::PROGRAM; // Node kind
+
+        Node* block;                        // Block
+        std::vector<std::string> variables; // Variable names indexed by slot (filled by the Resolver)
+
+        ProgramNode(Position position, Node* block) : Node(KIND, position), block(block) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "ProgramNode\n";
+            block->print(out, indent + 2);
+        }
+};
+
+// Block Node
+class BlockNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::BLOCK; // Node kind
+
+        // Child nodes
+        Node* decls; // Declarations
+        Node* stmts; // Statements
+
+        BlockNode(Position position, Node* decls, Node* stmts) : Node(KIND, position), decls(decls), stmts(stmts) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "BlockNode\n";
+            if (decls) decls->print(out, indent + 2);
+            if (stmts) stmts->print(out, indent + 2);
+        }
+};
+
+// Declarations Node
+class DeclsNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::DECLS; // Node kind
+
+        // Child nodes, stored contiguously in the parser arena
+        Node** decls; // Declarations
+        size_t count; // Number of declarations
+
+        DeclsNode(Position position, Node** decls, size_t count) : Node(KIND, position), decls(decls), count(count) {} // Constructor
+
+        // Iteration over the declarations
+        Node* const* begin() const { return decls; }
+        Node* const* end() const { return decls + count; }
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "DeclsNode\n";
+            for (Node* decl : *this) decl->print(out, indent + 2);
+        }
+};
+
+// Statements Node
+class StmtsNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::STMTS; // Node kind
+
+        // Child nodes, stored contiguously in the parser arena
+        Node** stmts; // Statements
+        size_t count; // Number of statements
+
+        StmtsNode(Position position, Node** stmts, size_t count) : Node(KIND, position), stmts(stmts), count(count) {} // Constructor
+
+        // Iteration over the statements
+        Node* const* begin() const { return stmts; }
+        Node* const* end() const { return stmts + count; }
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "StmtsNode\n";
+            for (Node* stmt : *this) stmt->print(out, indent + 2);
+        }
+};
+
+// Declaration Node
+class DeclNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::DECL; // Node kind
+
+        // Child nodes
+        Node* type;       // Basic Type or Array Type
+        int symbol;          // Interned identifier
+        std::string_view id; // Identifier name (owned by the Interner)
+        int slot = -1;       // Variable slot (filled by the Resolver)
+
+        DeclNode(Position position, Node* type, int symbol, std::string_view id) : Node(KIND, position), type(type), symbol(symbol), id(id) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "DeclNode: " << id << "\n";
+            type->print(out, indent + 2);
+        }
+};
+
+// Basic Type Node
+class BasicTypeNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::BASIC_TYPE; // Node kind
+
+        std::string_view typeName; // Type name
+
+        BasicTypeNode(Position position, std::string_view typeName) : Node(KIND, position), typeName(typeName) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "BasicTypeNode: " << typeName << "\n";
+        }
+};
+
+// Array Type Node
+class ArrayTypeNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::ARRAY_TYPE; // Node kind
+
+        Node* type;     // Basic type
+        int arraySize;  // Array size
+
+        ArrayTypeNode(Position position, Node* type, int arraySize) : Node(KIND, position), type(type), arraySize(arraySize) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "ArrayTypeNode: size = " << arraySize << "\n";
+            type->print(out, indent + 2);
+        }
+};
+
+// Identifier Node
+class IdNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::ID; // Node kind
+
+        int symbol;          // Interned identifier
+        std::string_view id; // Identifier name (owned by the Interner)
+        int slot = -1;       // Variable slot (filled by the Resolver)
+        bool checked = true; // Whether the access keeps its runtime declaration/initialization checks (cleared by the InitAnalysis)
+
+        IdNode(Position position, int symbol, std::string_view id) : Node(KIND, position), symbol(symbol), id(id) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "IdNode: " << id << "\n";
+        }
+};
+
+// Assignment Node
+class AssignNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::ASSIGN; // Node kind
+
+        // Child nodes
+        Node* loc;      // Locator
+        Node* expr;     // Expression
+
+        AssignNode(Position position, Node* loc, Node* expr) : Node(KIND, position), loc(loc), expr(expr) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "AssignNode\n";
+            loc->print(out, indent + 2);
+            expr->print(out, indent + 2);
+        }
+};
+
+// Array Access Node
+class ArrayAccessNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::ARRAY_ACCESS; // Node kind
+
+        Node* index;         // Expression
+        int symbol;          // Interned identifier
+        std::string_view id; // Identifier name (owned by the Interner)
+        int slot = -1;       // Variable slot (filled by the Resolver)
+        bool checkBounds = true; // Whether the access keeps its runtime bounds check (cleared by the RangeAnalysis)
+
+        ArrayAccessNode(Position position, Node* index, int symbol, std::string_view id) : Node(KIND, position), index(index), symbol(symbol), id(id) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "ArrayAccessNode: " << id << "\n";
+            index->print(out, indent + 2);
+        }
+};
+
+// Or Node
+class OrNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::OR; // Node kind
+
+        // Child nodes
+        Node* left;  // Left operand
+        Node* right; // Right operand
+
+        OrNode(Position position, Node* left, Node* right) : Node(KIND, position), left(left), right(right) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "OrNode\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// And Node
+class AndNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::AND; // Node kind
+
+        // Child nodes
+        Node* left;  // Left operand
+        Node* right; // Right operand
+
+        AndNode(Position position, Node* left, Node* right) : Node(KIND, position), left(left), right(right) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "AndNode\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// Equality Node (== and !=)
+class EqualityNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::EQUALITY; // Node kind
+
+        // Child nodes
+        Node* left;    // Left operand
+        Node* right;   // Right operand
+        bool isEqual;  // Type identifier (true for '==' and false for '!=')
+
+        EqualityNode(Position position, Node* left, Node* right, bool isEqual) : Node(KIND, position), left(left), right(right), isEqual(isEqual) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "EqualityNode: " << (isEqual ? "==" : "!=") << "\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// Relational Node (<, <=, >, >=)
+class RelNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::REL; // Node kind
+
+        enum Op { LESS, LESSEQ, GREATER, GREATEREQ }; // Operations
+        // Child nodes
+        Node* left;     // Left operand
+        Node* right;    // Right operand
+        Op op;          // Operation type
+
+        RelNode(Position position, Node* left, Node* right, Op op) : Node(KIND, position), left(left), right(right), op(op) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            static const char* opNames[] = { "<", "<=", ">", ">=" };
+            out << std::string(indent, ' ') << "RelNode: " << opNames[op] << "\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// Addition and Subtraction Node (+, -)
+class AddNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::ADD; // Node kind
+
+        // Child nodes
+        Node* left;         // Left operand
+        Node* right;        // Right operand
+        bool isAddition;    // Type identifier (true for '+' false for '-')
+
+        AddNode(Position position, Node* left, Node* right, bool isAddition) : Node(KIND, position), left(left), right(right), isAddition(isAddition) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "AddNode: " << (isAddition ? "+" : "-") << "\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// Multiplication and Division Node (*, /)
+class MulNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::MUL; // Node kind
+
+        // Child nodes
+        Node* left;             // Left operand
+        Node* right;            // Right operand
+        bool isMultiplication;  // Type identifier (true for '*' false for '/')
+
+        MulNode(Position position, Node* left, Node* right, bool isMultiplication) : Node(KIND, position), left(left), right(right), isMultiplication(isMultiplication) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "MulNode: " << (isMultiplication ? "*" : "/") << "\n";
+            left->print(out, indent + 2);
+            right->print(out, indent + 2);
+        }
+};
+
+// Unary Operations Node (!, -)
+class UnaryNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::UNARY; // Node kind
+
+        enum Op { NOT, NEG }; // Operations
+        Node* operand;        // Operand
+        Op op;                // Operation type
+
+        UnaryNode(Position position, Node* operand, Op op) : Node(KIND, position), operand(operand), op(op) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "UnaryNode: " << (op == NOT ? "!" : "-") << "\n";
+            operand->print(out, indent + 2);
+        }
+};
+
+// Factor Node (INT, BOOL, ID, LOC)
+class FactorNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::FACTOR; // Node kind
+
+        enum Type { BOOL, INT, ID }; // Types
+        Node* loc;          // Locator node
+        int intValue;       // Value if INT
+        bool boolValue;     // Value if BOOL
+        Type type;          // Type
+
+        FactorNode(Position position, Type type, int intValue = 0, bool boolValue = false, Node* loc = nullptr)
+            : Node(KIND, position), loc(loc), intValue(intValue), boolValue(boolValue), type(type) { // Constructor
+            // The type of a literal is known as soon as it is parsed
+            valueType = type == INT ? ValueType::INT : type == BOOL ? ValueType::BOOL : ValueType::UNKNOWN;
+        }
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "FactorNode: ";
+            switch(type) {
+                case BOOL: out << "bool = " << (boolValue ? "true" : "false") << "\n"; break;
+                case INT: out << "int = " << intValue << "\n"; break;
+                case ID: loc->print(out, indent + 2); break;
+            }
+        }
+};
+
+// If Node
+class IfNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::IF; // Node kind
+
+        // Child nodes
+        Node* condition; // Condition
+        Node* ifStmt;    // If statement
+
+        IfNode(Position position, Node* condition, Node* ifStmt) : Node(KIND, position), condition(condition), ifStmt(ifStmt) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "IfNode\n";
+            condition->print(out, indent + 2);
+            ifStmt->print(out, indent + 2);
+        }
+};
+
+// If Else Node
+class IfElseNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::IF_ELSE; // Node kind
+
+        // Child nodes
+        Node* condition; // Condition
+        Node* ifStmt;    // If statement
+        Node* elseStmt;  // Else statement
+
+        IfElseNode(Position position, Node* condition, Node* ifStmt, Node* elseStmt) : Node(KIND, position), condition(condition), ifStmt(ifStmt), elseStmt(elseStmt) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "IfElseNode\n";
+            condition->print(out, indent + 2);
+            ifStmt->print(out, indent + 2);
+            elseStmt->print(out, indent + 2);
+        }
+};
+
+// While Node
+class WhileNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::WHILE; // Node kind
+
+        // Child nodes
+        Node* condition; // Condition
+        Node* body;      // Body
+        VectorLoop* vector = nullptr; // Kernel running the iterations of an elementwise loop at once (filled by the Vectorizer)
+
+        WhileNode(Position position, Node* condition, Node* body) : Node(KIND, position), condition(condition), body(body) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "WhileNode\n";
+            condition->print(out, indent + 2);
+            body->print(out, indent + 2);
+        }
+};
+
+// Do While Node
+class DoWhileNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::DO_WHILE; // Node kind
+
+        // Child nodes
+        Node* condition; // Condition
+        Node* body;      // Body
+
+        DoWhileNode(Position position, Node* body, Node* condition) : Node(KIND, position), condition(condition), body(body) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "DoWhileNode\n";
+            body->print(out, indent + 2);
+            condition->print(out, indent + 2);
+        }
+};
+
+// Print Node
+class PrintNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::PRINT; // Node kind
+
+        Node* expr; // Expression
+
+        PrintNode(Position position, Node* expr) : Node(KIND, position), expr(expr) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "PrintNode\n";
+            expr->print(out, indent + 2);
+        }
+};
+
+// Break Node
+class BreakNode : public Node {
+    public:
+        static constexpr NodeKind KIND = NodeKind::BREAK; // Node kind
+
+        BreakNode(Position position) : Node(KIND, position) {} // Constructor
+
+        void print(std::ostream& out, int indent = 0) const {
+            out << std::string(indent, ' ') << "BreakNode\n";
+        }
+};
+
+// Returns the node as a T if it has the kind of T, nullptr otherwise
+template <typename T>
+T* node_cast(Node* node) {
+    return node && node->kind == T::KIND ? static_cast<T*>(node) : nullptr;
+}
+
+// Returns the node an expression stands for, skipping the factor wrapping a location
+inline Node* unwrap(Node* node) {
+    auto* factorNode = node_cast<FactorNode>(node);
+
+    return factorNode && factorNode->type == FactorNode::ID ? factorNode->loc : node;
+}
+
+// Returns the variable read by an expression when the InitAnalysis proved the read, nullptr otherwise
+inline IdNode* provenVariable(Node* node) {
+    auto* idNode = node_cast<IdNode>(unwrap(node));
+
+    return idNode && !idNode->checked ? idNode : nullptr;
+}
+
+// Checks if an expression is a literal, storing its value (booleans as 0 or 1)
+inline bool literalValue(Node* node, int& value) {
+    auto* factorNode = node_cast<FactorNode>(unwrap(node));
+    if (!factorNode || factorNode->type == FactorNode::ID) {
+        return false;
+    }
+
+    value = factorNode->type == FactorNode::INT ? factorNode->intValue : factorNode->boolValue;
+    return true;
+}
+
+// Checks if two expressions always evaluate to the same value (expressions have no side effects):
+// the same operations on the same literals, variables and array elements
+inline bool sameExpr(Node* left, Node* right) {
+    left = unwrap(left);
+    right = unwrap(right);
+
+    if (left->kind != right->kind || left->valueType != right->valueType) {
+        return false;
+    }
+
+    switch (left->kind) {
+        case NodeKind::FACTOR: {
+            int leftValue, rightValue;
+            return literalValue(left, leftValue) && literalValue(right, rightValue) && leftValue == rightValue;
+        }
+        case NodeKind::ID:
+            return static_cast<IdNode*>(left)->slot == static_cast<IdNode*>(right)->slot;
+        case NodeKind::ARRAY_ACCESS: {
+            auto* leftAccess = static_cast<ArrayAccessNode*>(left);
+            auto* rightAccess = static_cast<ArrayAccessNode*>(right);
+            return leftAccess->slot == rightAccess->slot && sameExpr(leftAccess->index, rightAccess->index);
+        }
+        case NodeKind::UNARY: {
+            auto* leftUnary = static_cast<UnaryNode*>(left);
+            auto* rightUnary = static_cast<UnaryNode*>(right);
+            return leftUnary->op == rightUnary->op && sameExpr(leftUnary->operand, rightUnary->operand);
+        }
+        case NodeKind::MUL: {
+            auto* leftMul = static_cast<MulNode*>(left);
+            auto* rightMul = static_cast<MulNode*>(right);
+            return leftMul->isMultiplication == rightMul->isMultiplication
+                && sameExpr(leftMul->left, rightMul->left) && sameExpr(leftMul->right, rightMul->right);
+        }
+        case NodeKind::ADD: {
+            auto* leftAdd = static_cast<AddNode*>(left);
+            auto* rightAdd = static_cast<AddNode*>(right);
+            return leftAdd->isAddition == rightAdd->isAddition
+                && sameExpr(leftAdd->left, rightAdd->left) && sameExpr(leftAdd->right, rightAdd->right);
+        }
+        case NodeKind::OR: {
+            auto* leftOr = static_cast<OrNode*>(left);
+            auto* rightOr = static_cast<OrNode*>(right);
+            return sameExpr(leftOr->left, rightOr->left) && sameExpr(leftOr->right, rightOr->right);
+        }
+        case NodeKind::AND: {
+            auto* leftAnd = static_cast<AndNode*>(left);
+            auto* rightAnd = static_cast<AndNode*>(right);
+            return sameExpr(leftAnd->left, rightAnd->left) && sameExpr(leftAnd->right, rightAnd->right);
+        }
+        case NodeKind::EQUALITY: {
+            auto* leftEq = static_cast<EqualityNode*>(left);
+            auto* rightEq = static_cast<EqualityNode*>(right);
+            return leftEq->isEqual == rightEq->isEqual
+                && sameExpr(leftEq->left, rightEq->left) && sameExpr(leftEq->right, rightEq->right);
+        }
+        case NodeKind::REL: {
+            auto* leftRel = static_cast<RelNode*>(left);
+            auto* rightRel = static_cast<RelNode*>(right);
+            return leftRel->op == rightRel->op
+                && sameExpr(leftRel->left, rightRel->left) && sameExpr(leftRel->right, rightRel->right);
+        }
+        default:
+            return false;
+    }
+}
+
+// Calls the visitor with the node cast to its concrete subclass
+template <typename Visitor>
+decltype(auto) visit(Node* node, Visitor&& visitor) {
+    switch (node->kind) {
+        case NodeKind::PROGRAM: return visitor(static_cast<ProgramNode*>(node));
+        case NodeKind::BLOCK: return visitor(static_cast<BlockNode*>(node));
+        case NodeKind::DECLS: return visitor(static_cast<DeclsNode*>(node));
+        case NodeKind::STMTS: return visitor(static_cast<StmtsNode*>(node));
+        case NodeKind::DECL: return visitor(static_cast<DeclNode*>(node));
+        case NodeKind::BASIC_TYPE: return visitor(static_cast<BasicTypeNode*>(node));
+        case NodeKind::ARRAY_TYPE: return visitor(static_cast<ArrayTypeNode*>(node));
+        case NodeKind::ID: return visitor(static_cast<IdNode*>(node));
+        case NodeKind::ASSIGN: return visitor(static_cast<AssignNode*>(node));
+        case NodeKind::ARRAY_ACCESS: return visitor(static_cast<ArrayAccessNode*>(node));
+        case NodeKind::OR: return visitor(static_cast<OrNode*>(node));
+        case NodeKind::AND: return visitor(static_cast<AndNode*>(node));
+        case NodeKind::EQUALITY: return visitor(static_cast<EqualityNode*>(node));
+        case NodeKind::REL: return visitor(static_cast<RelNode*>(node));
+        case NodeKind::ADD: return visitor(static_cast<AddNode*>(node));
+        case NodeKind::MUL: return visitor(static_cast<MulNode*>(node));
+        case NodeKind::UNARY: return visitor(static_cast<UnaryNode*>(node));
+        case NodeKind::FACTOR: return visitor(static_cast<FactorNode*>(node));
+        case NodeKind::IF: return visitor(static_cast<IfNode*>(node));
+        case NodeKind::IF_ELSE: return visitor(static_cast<IfElseNode*>(node));
+        case NodeKind::WHILE: return visitor(static_cast<WhileNode*>(node));
+        case NodeKind::DO_WHILE: return visitor(static_cast<DoWhileNode*>(node));
+        case NodeKind::PRINT: return visitor(static_cast<PrintNode*>(node));
+        case NodeKind::BREAK: break;
+    }
+    return visitor(static_cast<BreakNode*>(node)); // Last kind, kept out of the switch so every path returns
+}
+
+// Prints the node through the print function of its subclass
+inline void Node::print(std::ostream& out, int indent) const {
+    visit(const_cast<Node*>(this), [&](auto* node) { node->print(out, indent); });
+}
+
+// Helper function to handle the printing of the AST
+inline std::ostream& operator<<(std::ostream& out, const Node& node) {
+    node.print(out);
+    return out;
+}
+
+#endif // AST_H
@@ -0,0 +1,98 @@
+// File created by fob
+
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "ast.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// The bytecode is the linear form of the AST executed by the VM.
+// Every instruction works on a set of registers (r) and on the program variables (v),
+// which are addressed by the slots assigned by the Resolver.
+// The program is type checked, so registers hold plain integers (booleans as 0 or 1)
+// and each operation has a variant for each type instead of checking types at runtime.
+// The hottest shapes of the loops (increments, loop conditions, element updates) are fused by the
+// Compiler into single superinstructions.
+
+// Operation codes of the virtual machine, the operand layout is shown next to each opcode
+enum class OpCode : uint8_t {
+    LOAD_INT,       // r[a] = int b
+    LOAD_BOOL,      // r[a] = bool b
+    LOAD_VAR,       // r[a] = v[b], checking that v[b] is declared and initialized
+    LOAD_VAR_FAST,  // r[a] = v[b], proven declared and initialized by the InitAnalysis
+    LOAD_ELEM,      // r[a] = v[b][r[c]]
+    LOAD_ELEM_FAST, // r[a] = v[b][r[c]], index proven in bounds by the RangeAnalysis
+    STORE_VAR,      // v[a] = r[b], checking that v[a] is declared and marking it initialized
+    STORE_VAR_FAST, // v[a] = r[b], proven declared and never read by a checked LOAD_VAR
+    STORE_ELEM,     // v[a][r[b]] = r[c]
+    STORE_ELEM_FAST, // v[a][r[b]] = r[c], index proven in bounds by the RangeAnalysis
+    INC_VAR,        // v[a] = v[a] + int b, proven declared and initialized (x = x + 1)
+    ADD_ELEM,       // v[a][r[b]] = v[a][r[b]] + r[c], checking the bounds and the initialization (a[i] = a[i] + x)
+    ADD_ELEM_FAST,  // v[a][r[b]] = v[a][r[b]] + r[c], index proven in bounds by the RangeAnalysis
+    VECTOR_LOOP,    // runs the VectorLoop of the WhileNode of the instruction, leaving the loop the iterations left
+    CHECK_DECLARED, // checks that v[a] is declared, ahead of operands that may fail before the access (x = 5 / z)
+    DECLARE,        // declares v[a] of type b (0 int, 1 bool), c is the array size or -1 for scalars
+    ADD,            // r[a] = r[b] + r[c] (integers)
+    SUB,            // r[a] = r[b] - r[c] (integers)
+    MUL,            // r[a] = r[b] * r[c] (integers)
+    DIV,            // r[a] = r[b] / r[c] (integers)
+    ADD_BOOL,       // r[a] = r[b] || r[c] (boolean +)
+    SUB_BOOL,       // r[a] = r[b] != r[c] (boolean -)
+    MUL_BOOL,       // r[a] = r[b] && r[c] (boolean *)
+    DIV_BOOL,       // r[a] = r[b] if r[c] is true (boolean /)
+    EQ,             // r[a] = r[b] == r[c]
+    NEQ,            // r[a] = r[b] != r[c]
+    LESS,           // r[a] = r[b] < r[c]
+    LESSEQ,         // r[a] = r[b] <= r[c]
+    GREATER,        // r[a] = r[b] > r[c]
+    GREATEREQ,      // r[a] = r[b] >= r[c]
+    NOT,            // r[a] = !r[b]
+    NEG,            // r[a] = -r[b]
+    TO_BOOL,        // r[a] = (bool) r[b]
+    JUMP,           // pc = a
+    JUMP_IF_FALSE,  // if (!r[a]) pc = b
+    JUMP_IF_TRUE,   // if (r[a]) pc = b
+    JUMP_IF_LESS,       // if (v[a] < v[b]) pc = c, both variables proven initialized (while (i < n))
+    JUMP_IF_LESSEQ,     // if (v[a] <= v[b]) pc = c
+    JUMP_IF_GREATER,    // if (v[a] > v[b]) pc = c
+    JUMP_IF_GREATEREQ,  // if (v[a] >= v[b]) pc = c
+    JUMP_IF_EQ,         // if (v[a] == v[b]) pc = c
+    JUMP_IF_NEQ,        // if (v[a] != v[b]) pc = c
+    JUMP_IF_LESS_INT,       // if (v[a] < int b) pc = c, the variable proven initialized (while (i < 100))
+    JUMP_IF_LESSEQ_INT,     // if (v[a] <= int b) pc = c
+    JUMP_IF_GREATER_INT,    // if (v[a] > int b) pc = c
+    JUMP_IF_GREATEREQ_INT,  // if (v[a] >= int b) pc = c
+    JUMP_IF_EQ_INT,         // if (v[a] == int b) pc = c
+    JUMP_IF_NEQ_INT,        // if (v[a] != int b) pc = c
+    PRINT,          // prints r[a] of type b (0 int, 1 bool)
+    BREAK,          // break outside of any loop
+    HALT            // end of the program
+};
+
+// Single fixed size instruction
+struct Instruction {
+    OpCode op;  // Operation code
+    int a;      // First operand
+    int b;      // Second operand
+    int c;      // Third operand
+};
+
+// A compiled program ready to be executed by the VM
+struct Chunk {
+    std::vector<Instruction> code;          // Instructions
+    std::vector<Node *> nodes;              // Source node of each instruction (used for error reporting)
+    std::vector<std::string> variables;     // Variable names indexed by slot
+    int registerCount = 0;                  // Number of registers needed to run the code
+};
+
+// Converts an opcode to a human-readable string.
+std::string to_string(OpCode op);
+
+// Helper function to handle the printing of the bytecode
+std::ostream& operator<<(std::ostream& out, const Chunk& chunk);
+
+#endif // BYTECODE_H
@@ -0,0 +1,61 @@
+// File created by fob
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "arena.h"
+#include "ast.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// The ProgramCache stores the checked and optimized AST of a source in a compact binary file, so the
+// next runs of an unchanged source map the file and rebuild the tree without running the Lexer, the
+// Parser and the static passes. Each file records the hash and size of the source it was built from
+// and the hash of its own content: a stale, truncated or corrupt file is never loaded, the program
+// is built from the source again and the file is rewritten. The array bounds proofs of the RangeAnalysis
+// and the kernels of the Vectorizer are the only facts not stored, they are built again on the loaded tree.
+class ProgramCache {
+public:
+    // Constructor: with an empty directory the cache file of a source is written next to it
+    // (<source>.iecc), otherwise it goes into the directory, named after the hash of the source
+    explicit ProgramCache(std::string directory = "");
+
+    // Rebuilds the program cached for a source, allocating the nodes (and their names) in the arena.
+    // Returns nullptr when there is no valid cache file.
+    Node *load(const std::string &sourcePath, std::string_view source, Arena &arena) const;
+
+    // Writes the cache file of a checked program, a failure only means the next run builds it again
+    void store(const std::string &sourcePath, std::string_view source, const Node *program) const;
+
+private:
+    // Bumped whenever the nodes or the passes change what a cached tree holds
+    static constexpr uint32_t VERSION = 3;
+
+    // Fixed-size header at the start of a cache file
+    struct Header {
+        uint32_t magic;         // MAGIC, also read back wrongly on a machine with a different byte order
+        uint32_t version;       // VERSION of the writer
+        uint64_t sourceHash;    // Hash of the source the tree was built from
+        uint64_t sourceSize;    // Size of that source
+        uint64_t payloadHash;   // Hash of the encoded tree following the header
+        uint64_t payloadSize;   // Size of the encoded tree
+    };
+
+    static constexpr uint32_t MAGIC = 0x43434549; // "IECC"
+
+    // Encode and decode the payload of a cache file (defined in cache.cpp)
+    class Writer;
+    class Reader;
+
+    std::string directory; // Directory holding the cache files (empty: next to the sources)
+
+    // Returns the path of the cache file of a source with the given hash
+    std::string pathOf(const std::string &sourcePath, uint64_t sourceHash) const;
+
+    // Returns the 64-bit FNV-1a hash of some bytes
+    static uint64_t hash(std::string_view bytes);
+};
+
+#endif // CACHE_H
@@ -0,0 +1,52 @@
+// File created by fob
+
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "ast.h"
+#include "bytecode.h"
+
+#include <string>
+#include <vector>
+
+// The Compiler lowers the resolved AST into a linear bytecode Chunk
+// that can be executed by the VM without walking the tree again.
+class Compiler {
+public:
+    // Compiles a whole program starting from its root ProgramNode (the program must be resolved)
+    Chunk compile(Node *node);
+
+private:
+    Chunk chunk;                                // Chunk being built
+    std::vector<std::vector<int>> breakJumps;   // Pending break jumps of each enclosing loop
+
+    // Appends an instruction and returns its position
+    int emit(OpCode op, Node *node, int a = 0, int b = 0, int c = 0);
+
+    // Sets the target of the jump instruction at the given position
+    void patchJump(int position, int target);
+
+    // Helper functions for compiling different parts of the AST
+    void compileBlock(Node *node);    // Compiles a block of code
+    void compileDecls(Node *node);    // Compiles variable declarations
+    void compileDecl(Node *node);     // Compiles a single variable declaration
+    void compileStmts(Node *node);    // Compiles a list of statements
+    void compileStmt(Node *node);     // Compiles a single statement
+
+    // Compiles an expression storing its value in the register dst, registers above dst are used as temporaries
+    void compileExpr(Node *node, int dst);
+
+    // Compiles an assignment to a variable location
+    void compileAssign(Node *locNode, Node *exprNode);
+
+    // Compiles a binary operation whose operands are evaluated in order
+    void compileBinary(OpCode op, Node *node, Node *left, Node *right, int dst);
+
+    // Compiles a jump to target taken when the condition evaluates to when, returns its position
+    int compileBranch(Node *condition, bool when, Node *node, int target = 0);
+
+    // Throws a compile error with a specific message related to a node
+    static void throwError(const std::string &message, Node *node);
+};
+
+#endif // COMPILER_H
@@ -0,0 +1,48 @@
+// File created by fob
+
+#ifndef INITANALYSIS_H
+#define INITANALYSIS_H
+
+#include "ast.h"
+
+#include <vector>
+
+// The InitAnalysis is a forward dataflow pass run on the type checked (and optimized) AST.
+// It computes the scalar variables that are definitely declared and definitely initialized
+// at each statement and clears IdNode::checked on the accesses that can never fail,
+// so the runtime skips the declaration and initialization checks (and the bookkeeping
+// of the initialized flag on the assignments of variables that are never checked).
+// Array elements depend on runtime indices and are always tracked at runtime.
+class InitAnalysis {
+public:
+    // Analyzes a whole program starting from its root ProgramNode
+    void analyze(Node *node);
+
+private:
+    // Facts holding at a program point
+    struct State {
+        std::vector<bool> declared;     // Slots definitely declared
+        std::vector<bool> initialized;  // Scalar slots definitely initialized
+        bool reachable = true;          // False after a break (the following code never runs)
+    };
+
+    State state;                        // Facts at the current program point
+    std::vector<State> breakStates;     // Facts at the breaks of each enclosing loop
+    std::vector<bool> checkedReads;     // Slots with at least one read that keeps its runtime checks
+    std::vector<IdNode *> writes;       // Assignments to scalar variables
+
+    // Keeps in a state only the facts that also hold in another one (the join of two paths)
+    static void merge(State &into, const State &from);
+
+    // Records in kills the slots declared inside a statement (a declaration resets the variable)
+    static void collectKills(Node *node, std::vector<bool> &kills);
+
+    // Helper functions for analyzing the different parts of the AST
+    void analyzeBlock(Node *node);    // Analyzes the declarations and statements of a block
+    void analyzeStmt(Node *node);     // Analyzes a single statement
+    void analyzeLoopHead(Node *body); // Moves the state to the head of a loop with the given body
+    void analyzeExpr(Node *node);     // Analyzes the reads of an expression
+    void analyzeRead(IdNode *node);   // Analyzes the read of a scalar variable
+};
+
+#endif // INITANALYSIS_H
@@ -0,0 +1,30 @@
+// File created by fob
+
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// The Interner is the identifier table shared by the Lexer, the Parser and the Interpreter.
+// Each distinct name is stored once and turned into a small integer symbol at lex time,
+// so later stages compare and index symbols instead of hashing strings again.
+class Interner {
+public:
+    // Returns the symbol of a name, adding the name to the table the first time it is seen
+    int intern(std::string_view name);
+
+    // Returns the name of a symbol, the view stays valid as long as the interner is alive
+    std::string_view name(int symbol) const;
+
+    // Returns the number of distinct names in the table
+    int size() const;
+
+private:
+    std::deque<std::string> names;                      // Names indexed by symbol (a deque never moves them)
+    std::unordered_map<std::string_view, int> symbols;  // Symbols by name, keys view into names
+};
+
+#endif // INTERNER_H
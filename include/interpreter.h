@@ -1,105 +1,229 @@
-// File created by fob
-
-#ifndef INTERPRETER_H
-#define INTERPRETER_H
-
-#include "ast.h"
-
-#include <string>
-#include <unordered_map>
-#include <variant>
-#include <vector>
-
-// Enum representing the supported data types in the language (integer and boolean)
-enum class Type { INT, BOOL };
-
-// Struct to represent the result of evaluating an expression
-// Stores both the type and the value of the result
-struct Result {
-    Type type;      // The type of the result (INT or BOOL)
-    int value;      // The value, represented as an integer (for both int and bool types)
-
-    // Constructor for integer results
-    Result(int value) : type(Type::INT), value(value) {}
-
-    // Constructor for boolean results
-    Result(bool value) : type(Type::BOOL), value(value) {}
-};
-
-// Class representing a variable in the program
-// Can store either a single value or an array of values
-class Variable {
-public:
-    Type type;                      // The data type of the variable (INT or BOOL)
-    int intValue;                   // Single integer value (if not an array)
-    bool boolValue;                 // Single boolean value (if not an array)
-    bool isArray;                   // Flag indicating whether the variable is an array
-    std::vector<int> intArray;      // Array of integer values (if the variable is an array)
-    std::vector<bool> boolArray;    // Array of boolean values (if the variable is an array)
-
-    bool initialized;                   // Flag indicating if the single value is initialized
-    std::vector<bool> arrayInitialized; // Flags for initialization of each array element (if it's an array)
-
-    // Default constructor
-    Variable() : isArray(false), intValue(0), boolValue(false) {}
-
-    // Returns the size of the array if it is an array
-    int size() const;
-};
-
-// Class representing the symbol table (or variable map) for the program
-// It stores variables and supports variable declarations and lookups
-class SymbolMap {
-public:
-    // Checks if a variable with a given name is already declared
-    bool isDeclared(const std::string &name) const;
-
-    // Declares a new variable with a given name, type, and array size (optional)
-    void declareVariable(const std::string &name, Type type, bool isArray = false, int arraySize = 0);
-
-    // Returns a reference to the Variable object for a given variable name
-    Variable &getVariable(const std::string &name);
-
-private:
-    // Hashmap to store the declared variables by name
-    std::unordered_map<std::string, Variable> map;
-};
-
-
-// Class representing the interpreter that executes the abstract syntax tree (AST)
-class Interpreter {
-public:
-    // Exception class for handling break statements in loops
-    class BreakException : public std::exception {
-    public:
-        // Custom message for the break exception
-        const char* what() const noexcept override {
-            return "Break statement encountered";
-        }
-    };
-
-    // Main function to interpret (execute) a given AST node
-    void interpret(Node *node);
-
-private:
-    // Symbol table for managing declared variables during interpretation
-    SymbolMap symbolMap;
-
-    // Helper functions for interpreting different parts of the AST
-    void executeBlock(Node *node);    // Interprets a block of code (e.g., inside a function or a loop)
-    void executeDecls(Node *node);    // Interprets variable declarations
-    void executeDecl(Node *node);     // Interprets a single variable declaration
-    void executeStmts(Node *node);    // Interprets a list of statements
-    void executeStmt(Node *node);     // Interprets a single statement
-
-    // Evaluates an expression node and returns the resulting value
-    Result evaluateExpr(Node *node);
-
-    // Utility function to assign a value to a variable location
-    void assignValue(Node *locNode, Node *node);
-
-    // Throws a runtime error with a specific message related to a node
-    static void throwError(const std::string &message, Node *node);
-};
-
+// File created by fob
+
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include "ast.h"
+#include "output.h"
+#include "profiler.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Integer arithmetic of the language, shared by every engine and the Optimizer: ints wrap around on
+// overflow (two's complement, computed on unsigned values so C++ never overflows), and as -INT_MIN is
+// INT_MIN, so is INT_MIN / -1. The divisor of wrapDiv must not be 0.
+inline int wrapAdd(int left, int right) { return (int) ((uint32_t) left + (uint32_t) right); }
+inline int wrapSub(int left, int right) { return (int) ((uint32_t) left - (uint32_t) right); }
+inline int wrapMul(int left, int right) { return (int) ((uint32_t) left * (uint32_t) right); }
+inline int wrapNeg(int operand) { return (int) (0u - (uint32_t) operand); }
+inline int wrapDiv(int left, int right) { return right == -1 ? wrapNeg(left) : left / right; }
+
+// Enum representing the supported data types in the language (integer and boolean)
+enum class Type : uint8_t { INT, BOOL };
+
+// Struct to represent the result of evaluating an expression
+// Stores both the type and the value of the result
+struct Result {
+    Type type;      // The type of the result (INT or BOOL)
+    int value;      // The value, represented as an integer (for both int and bool types)
+
+    // Constructor for integer results
+    Result(int value) : type(Type::INT), value(value) {}
+
+    // Constructor for boolean results
+    Result(bool value) : type(Type::BOOL), value(value) {}
+};
+
+// Class representing the state of a variable in the program
+// The values live in the SymbolMap: scalars in a flat value array, arrays in an ArrayStorage
+class Variable {
+public:
+    Type type = Type::INT;      // The data type of the variable (INT or BOOL)
+    bool isArray = false;       // Flag indicating whether the variable is an array
+    bool declared = false;      // Flag indicating if the variable has been declared
+    bool initialized = false;   // Flag indicating if the single value is initialized
+};
+
+// Class representing the elements of an array variable
+// Integers are stored in a contiguous 32-bit buffer, booleans and the initialization flags
+// of the elements are packed 64 to a word. The buffers are reused when the array is redeclared.
+class ArrayStorage {
+public:
+    // Resets the array to a given number of zeroed and uninitialized elements of a given type
+    void reset(Type type, int length);
+
+    // Returns the number of elements
+    int size() const { return length; }
+
+    // Returns the element at a given index (booleans as 0 or 1)
+    int load(int index) const {
+        if (isBool) {
+            return (int) ((bools[index >> 6] >> (index & 63)) & 1);
+        }
+        return ints[index];
+    }
+
+    // Stores a value (booleans as 0 or 1) at a given index and marks the element initialized
+    void store(int index, int value) {
+        uint64_t mask = uint64_t(1) << (index & 63);
+
+        if (isBool) {
+            bools[index >> 6] = value ? bools[index >> 6] | mask : bools[index >> 6] & ~mask;
+        } else {
+            ints[index] = value;
+        }
+        initialized[index >> 6] |= mask;
+    }
+
+    // Checks if the element at a given index is initialized
+    bool isInitialized(int index) const {
+        return (initialized[index >> 6] >> (index & 63)) & 1;
+    }
+
+    // Returns the first uninitialized element in [from, to), or to when they are all initialized
+    int firstUninitialized(int from, int to) const;
+
+    // Marks the elements in [from, to) initialized
+    void markInitialized(int from, int to);
+
+    // Returns the integer elements (the kernels of the VectorLoop work on them directly)
+    int32_t *intData() {
+        return ints.data();
+    }
+
+    // Returns the boolean elements, packed 64 to a word
+    uint64_t *boolData() {
+        return bools.data();
+    }
+
+private:
+    bool isBool = false;                // Flag indicating whether the elements are booleans
+    int length = 0;                     // Number of elements
+    std::vector<int32_t> ints;          // Integer elements
+    std::vector<uint64_t> bools;        // Boolean elements, one bit each
+    std::vector<uint64_t> initialized;  // Initialization flags of the elements, one bit each
+};
+
+// Class representing the symbol table (or variable map) for the program
+// Variables, scalar values and arrays are stored in flat arrays indexed by the slots assigned by the Resolver
+class SymbolMap {
+public:
+    // Prepares an undeclared slot for each variable name of the program.
+    // The names are not copied, they must outlive the map (they belong to the program or the chunk).
+    void reset(const std::vector<std::string> &names);
+
+    // Checks if the variable in a given slot is already declared
+    bool isDeclared(int slot) const;
+
+    // Declares a new variable in a given slot with type and array size (optional)
+    void declareVariable(int slot, Type type, bool isArray = false, int arraySize = 0);
+
+    // Returns a reference to the declared Variable object in a given slot
+    Variable &getVariable(int slot) {
+        Variable &variable = variables[slot];
+
+        if (!variable.declared) {
+            throwUndeclared(slot);
+        }
+
+        return variable;
+    }
+
+    // Returns the value of the scalar variable in a given slot (booleans as 0 or 1) without checking
+    // the declaration, for the accesses that the InitAnalysis proved or that checked it with getVariable
+    int &value(int slot) {
+        return values[slot];
+    }
+
+    // Returns the scalar values indexed by slot (the machine code of the JIT addresses them directly)
+    int *valueData() {
+        return values.data();
+    }
+
+    // Returns the elements of the declared array variable in a given slot
+    ArrayStorage &getArray(int slot) {
+        if (!variables[slot].declared) {
+            throwUndeclared(slot);
+        }
+
+        return arrays[slot];
+    }
+
+    // Returns the name of the variable in a given slot
+    const std::string &getName(int slot) const;
+
+private:
+    std::vector<Variable> variables;    // Variables indexed by slot
+    std::vector<int> values;            // Scalar values indexed by slot
+    std::vector<ArrayStorage> arrays;   // Array elements indexed by slot (empty for scalars)
+    const std::vector<std::string> *names = nullptr;  // Variable names indexed by slot
+
+    // Throws the error for an access to an undeclared variable
+    [[noreturn]] void throwUndeclared(int slot) const;
+};
+
+
+// Messages of the runtime errors of the accesses, shared by the engines (each one adds the position of the access)
+std::string outOfBoundsMessage(int index, int size);
+std::string uninitializedMessage(const std::string &name);
+std::string uninitializedElementMessage(const std::string &name, int index);
+
+// Class representing the interpreter that executes the abstract syntax tree (AST)
+// The AST must have been resolved and type checked
+class Interpreter {
+public:
+    // Exception class for break statements found outside of any loop
+    class BreakException : public std::exception {
+    public:
+        // Custom message for the break exception
+        const char* what() const noexcept override {
+            return "Break statement encountered";
+        }
+    };
+
+    // Constructor: print statements write to the given sink, statements are timed when a profiler is given
+    explicit Interpreter(OutputSink &output, Profiler *profiler = nullptr);
+
+    // Main function to interpret (execute) a given AST node
+    void interpret(Node *node);
+
+private:
+    // Control flow status returned by the statements: a break unwinds the statements
+    // up to the innermost loop as a plain return value instead of a C++ exception
+    enum class Flow : uint8_t {
+        NORMAL, // Continue with the next statement
+        BREAK   // Leave the innermost enclosing loop
+    };
+
+    // Symbol table for managing declared variables during interpretation
+    SymbolMap symbolMap;
+
+    // Destination of the print statements
+    OutputSink &output;
+
+    // Statistics of the statements (nullptr when not profiling)
+    Profiler *profiler;
+
+    // Helper functions for interpreting different parts of the AST
+    // The statements are instantiated twice: with Profile each statement is timed, without it runs untouched
+    template <bool Profile> Flow executeBlock(Node *node);    // Interprets a block of code (e.g., inside a function or a loop)
+    void executeDecls(Node *node);                            // Interprets variable declarations
+    void executeDecl(Node *node);                             // Interprets a single variable declaration
+    template <bool Profile> Flow executeStmts(Node *node);    // Interprets a list of statements
+    template <bool Profile> Flow executeStmt(Node *node);     // Interprets a single statement
+
+    // Evaluates a type checked expression node and returns the resulting value (booleans as 0 or 1)
+    int evaluateExpr(Node *node);
+
+    // Utility function to assign a value to a variable location
+    void assignValue(Node *locNode, Node *node);
+
+    // Throws a runtime error with a specific message related to a node
+    static void throwError(const std::string &message, Node *node);
+};
+
 #endif // INTERPRETER_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+// File created by fob
+
+#ifndef INVARIANTMOTION_H
+#define INVARIANTMOTION_H
+
+#include "arena.h"
+#include "ast.h"
+
+#include <utility>
+#include <vector>
+
+// The InvariantMotion moves loop invariant expressions out of the while and do-while loops.
+// It runs after the InitAnalysis, on the proven variable reads. An expression is invariant in a loop
+// when it only reads variables that the loop (its condition and its body, nested loops included)
+// never assigns nor declares: it is computed once into a new temporary variable right before the
+// loop, and every copy of it inside the loop reads the temporary. Loops are handled from the
+// outermost one, so an expression leaves every loop it does not depend on.
+// Only expressions that can never fail are moved: literals, proven variable reads, arithmetic,
+// comparisons and logic operations, divisions by a literal other than 0. Computing them
+// earlier, or when the loop would not reach them, cannot raise an error nor change which error is
+// raised, so a division by zero or an array access still fails inside the loop at its own position.
+class InvariantMotion {
+public:
+    // Constructor: the temporaries and their assignments are allocated in the arena owning the AST
+    explicit InvariantMotion(Arena &arena);
+
+    // Optimizes a whole program in place starting from its root ProgramNode,
+    // the temporaries are added to ProgramNode::variables
+    void optimize(Node *node);
+
+private:
+    Arena &arena;                       // Arena where the new nodes are allocated
+    ProgramNode *program = nullptr;     // Program being optimized
+    std::vector<bool> written;          // Slots assigned or declared by the loop being optimized
+    std::vector<std::pair<Node *, IdNode *>> hoisted;   // Expressions moved out of that loop and their temporaries
+
+    // Marks in written the slots assigned or declared inside a statement
+    static void collectWrites(Node *node, std::vector<bool> &written);
+
+    // Returns the statement with its loops optimized, a loop with invariant expressions
+    // becomes a block assigning the temporaries and then running the loop
+    Node *optimizeStmt(Node *node);
+
+    // Replaces the invariant expressions of a statement of the loop being optimized
+    void moveStmt(Node *node);
+
+    // Returns whether an expression is invariant in the loop being optimized. When it is not,
+    // its invariant operands are replaced by temporaries.
+    bool moveExpr(Node *&node);
+
+    // Replaces an invariant expression by the read of a temporary (literals and variables are kept),
+    // the copies of the same expression (sameExpr) share it
+    void hoist(Node *&node);
+};
+
+#endif // INVARIANTMOTION_H
@@ -0,0 +1,96 @@
+// File created by fob
+
+#ifndef JIT_H
+#define JIT_H
+
+#include "vm.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Template JIT translating the bytecode produced by the Compiler into x86-64 machine code.
+// Each instruction is replaced by a fixed machine code template working on the same registers
+// and scalar values as the VM: arithmetic, comparisons, jumps and the scalar accesses proven by the
+// InitAnalysis run inline, the other instructions (checked accesses, arrays, declarations, prints)
+// call back into the VM (VM::execute). Runtime errors leave the machine code through an exit stub and are thrown
+// once back in C++, so no exception ever unwinds through the generated code.
+// It follows the same semantics (and error messages) as the VM.
+// The machine code never refers to the state of an execution, which is passed to it on entry:
+// once compiled, the same chunk can be run many times, from several threads at once.
+class JIT {
+public:
+    // Constructor
+    JIT() = default;
+
+    // Destructor: releases the machine code
+    ~JIT();
+
+    // The JIT owns its executable mapping, so it cannot be copied
+    JIT(const JIT &) = delete;
+    JIT &operator=(const JIT &) = delete;
+
+    // Translates a chunk into machine code, returns false when this machine cannot run it
+    // (not an x86-64 system, or no executable memory), the chunk must outlive the JIT
+    bool compile(const Chunk &chunk);
+
+    // Runs the compiled chunk from its first instruction until HALT, PRINT instructions write to the sink.
+    // Each run has its own variables and registers.
+    void run(OutputSink &output) const;
+
+private:
+    // Ways to leave the machine code, returned with the pc of the instruction that left it
+    enum class Exit : uint32_t {
+        HALT,               // End of the program
+        ERROR,              // A runtime error, the message is in error
+        DIVISION_BY_ZERO,   // A division by zero
+        BREAK               // A break outside of any loop
+    };
+
+    // State of a run of the machine code
+    struct Execution {
+        const JIT &jit;                 // Compiled chunk being run
+        OutputSink &output;             // Destination of the PRINT instructions
+        SymbolMap symbolMap;            // Program variables indexed by slot
+        std::vector<int> registers;     // Registers holding intermediate results (booleans as 0 or 1)
+        std::string error;              // Message of the last runtime error raised by slowPath
+    };
+
+    // Entry point of the machine code: (execution, registers, scalar values) -> exit << 32 | pc
+    using Entry = uint64_t (*)(Execution *, int *, int *);
+
+    const Chunk *chunk = nullptr;       // Compiled chunk
+    uint8_t *machineCode = nullptr;     // Executable mapping holding the machine code
+    size_t machineCodeSize = 0;         // Size of the mapping
+
+    // Code generation state
+    std::vector<uint8_t> buffer;        // Machine code being generated
+    std::vector<size_t> labels;         // Offset of the template of each instruction
+    std::vector<std::pair<size_t, int>> jumps;                  // Jump displacements to patch with the label of a pc
+    std::vector<std::pair<size_t, uint64_t>> stubJumps;         // Jump displacements to patch with an exit stub
+
+    // Appends raw bytes and immediates to the buffer
+    void emit(std::initializer_list<uint8_t> bytes);
+    void emit32(uint32_t value);
+    void emit64(uint64_t value);
+
+    // Appends an instruction addressing [rbx + 4 * reg], a register of the VM
+    // (the opcode bytes end with the ModRM byte, the displacement follows)
+    void emitRegister(std::initializer_list<uint8_t> opcode, int reg);
+
+    // Appends a conditional jump (0x84 je, 0x85 jne) or a jump (0) to the template of a pc
+    void emitJump(uint8_t condition, int target);
+
+    // Appends a conditional jump (or a jump) to an exit stub leaving with the given exit and pc
+    void emitExit(uint8_t condition, Exit exit, int pc);
+
+    // Translates a single instruction
+    void compileInstruction(const Instruction &instruction, int pc);
+
+    // Executes an instruction without a machine code template as the VM does (VM::execute), called by
+    // the machine code. Returns 0 when it succeeds, 1 after an error (the message is left in execution->error).
+    static int slowPath(Execution *execution, int pc) noexcept;
+};
+
+#endif // JIT_H
@@ -1,85 +1,140 @@
-// File created by fob
-
-#ifndef LEXER_H
-#define LEXER_H
-
-#include <fstream>
-#include <ostream>
-#include <string>
-#include <unordered_map>
-
-// The Lexer class is responsible for tokenizing the input source code.
-// It processes the input file and converts it into a sequence of tokens
-// that will be used by the parser.
-class Lexer {
-public:
-    // Enumeration of possible tokens in the language
-    // Each token represents a type of symbol or keyword.
-    enum class Token {
-        NUM, ID, INT, BOOLEAN, TRUE, FALSE, LBRACE, RBRACE,
-        LBRACKET, RBRACKET, LPARENTHESIS, RPARENTHESIS, SEMICOLON,
-        IF, ELSE, WHILE, DO, BREAK, PRINT, EQ, NEQ, AND, OR, LESS,
-        LESSEQ, GREATER, GREATEREQ, ASSIGN, PLUS, MINUS, MULTIPLY,
-        DIVIDE, NOT, END, ERROR
-    };
-
-    // Constructor: Initializes the lexer with an input file stream.
-    // It also sets up the map for reserved keywords and reads the first character.
-    Lexer(std::ifstream &input);
-
-    // Returns the next token from the input stream.
-    Token nextToken();
-
-    // Accessors for the current token's value:
-    // - Returns the value of the number token if the current token is of type NUM.
-    int getNumber() const;
-
-    // - Returns the value of the identifier token if the current token is of type ID.
-    std::string getIdentifier() const;
-
-    // Utility methods for debugging and error reporting:
-    // - Returns the current line being processed.
-    int getLine() const;
-
-    // - Returns the current column being processed.
-    int getColumn() const;
-
-private:
-    // Private variables for lexing state:
-    std::ifstream &input;                            // Reference to the input file stream
-    char currentCharacter;                           // Current character being analyzed
-    std::unordered_map<std::string, Token> keywords; // Reserved keywords in the language
-
-    // Tracking line and column numbers for error reporting
-    int line = 1;        // Current line number
-    int column = 0;      // Current column number
-
-    // Variables for the values of current tokens
-    int numberValue;              // Holds the numeric value of NUM tokens
-    std::string identifierValue;  // Holds the string value of ID tokens
-
-    // Utility methods for lexing:
-    // - Reads the next character from the input file.
-    void advance();
-
-    // - Skips whitespace characters (spaces, tabs, newlines).
-    void skipWhitespace();
-
-    // - Parses and returns a numeric token (NUM).
-    Token scanNumber();
-
-    // - Parses and returns either an identifier token (ID) or a keyword token.
-    Token scanIdentifierOrKeyword();
-};
-
-// Utility functions for debugging and pretty-printing:
-
-// Converts the current state of the Lexer to a human-readable string.
-// Useful for debugging purposes.
-std::string to_string(const Lexer &lexer);
-
-// Converts a token to a human-readable string.
-// Useful for printing tokens during debugging or logging.
-std::string to_string(const Lexer::Token token);
-
-#endif // LEXER_H
+// File created by fob
+
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "interner.h"
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Position in the source, used for error reporting
+struct Position {
+    int line;   // Line number
+    int column; // Column number
+};
+
+struct TokenBuffer;
+
+// The Lexer class is responsible for tokenizing the input source code.
+// It scans an in-memory buffer (for example a memory-mapped SourceFile) with pointer
+// arithmetic and converts it into a sequence of tokens that will be used by the parser.
+class Lexer {
+public:
+    // Enumeration of possible tokens in the language
+    // Each token represents a type of symbol or keyword.
+    enum class Token : uint8_t {
+        NUM, ID, INT, BOOLEAN, TRUE, FALSE, LBRACE, RBRACE,
+        LBRACKET, RBRACKET, LPARENTHESIS, RPARENTHESIS, SEMICOLON,
+        IF, ELSE, WHILE, DO, BREAK, PRINT, EQ, NEQ, AND, OR, LESS,
+        LESSEQ, GREATER, GREATEREQ, ASSIGN, PLUS, MINUS, MULTIPLY,
+        DIVIDE, NOT, END, ERROR
+    };
+
+    // Constructor: Initializes the lexer over a source buffer, which must outlive the lexer,
+    // and positions it on the first character. Identifiers are interned into the given table.
+    Lexer(std::string_view source, Interner &interner);
+
+    // Constructor: Initializes the lexer with an input file stream, whose content is read into memory.
+    Lexer(std::ifstream &input, Interner &interner);
+
+    // Returns the next token from the input stream.
+    Token nextToken();
+
+    // Scans the whole input (up to END or the first ERROR token) into a token buffer.
+    TokenBuffer tokenize();
+
+    // Accessors for the current token's value:
+    // - Returns the value of the number token if the current token is of type NUM.
+    int getNumber() const;
+
+    // - Returns the value of the identifier token if the current token is of type ID.
+    //   The view points into the interner, so it outlives the source buffer.
+    std::string_view getIdentifier() const;
+
+    // - Returns the interned symbol of the identifier token if the current token is of type ID.
+    int getSymbol() const;
+
+    // Utility methods for debugging and error reporting:
+    // - Returns the current line being processed.
+    int getLine() const;
+
+    // - Returns the current column being processed.
+    int getColumn() const;
+
+private:
+    // Private variables for lexing state:
+    std::string buffer;                                   // Owned copy of the source when read from a stream
+    const char *start;                                    // First character of the source
+    const char *cursor;                                   // Current character being analyzed
+    const char *end;                                      // One past the last character of the source
+    Interner &interner;                                   // Table where identifiers are interned
+
+    // Tracking line and column numbers for error reporting
+    int line = 1;                   // Current line number
+    long lineBegin = -1;            // Offset of the newline opening the current line (-1 on the first line)
+    std::vector<uint32_t> newlines; // Offsets of the newlines met so far
+
+    // Variables for the values of current tokens
+    int numberValue;                    // Holds the numeric value of NUM tokens
+    int symbolValue;                    // Holds the interned symbol of ID tokens
+
+    // Utility methods for lexing:
+    // - Returns the current character, or the null character at the end of the source.
+    char current() const;
+
+    // - Moves to the next character of the source.
+    void advance();
+
+    // - Starts scanning a new source buffer from its first character.
+    void reset(std::string_view source);
+
+    // - Skips whitespace characters (spaces, tabs, newlines).
+    void skipWhitespace();
+
+    // - Parses and returns a numeric token (NUM).
+    Token scanNumber();
+
+    // - Parses and returns either an identifier token (ID) or a keyword token.
+    Token scanIdentifierOrKeyword();
+};
+
+// The TokenBuffer holds all the tokens of a source as a struct of arrays.
+// The Parser indexes into it instead of pulling tokens on demand, which makes lookahead
+// a matter of index arithmetic and lets lexing and parsing be measured separately.
+struct TokenBuffer {
+    std::vector<Lexer::Token> kinds;    // Kind of each token
+    std::vector<int> values;            // Value of NUM tokens, interned symbol of ID tokens, 0 otherwise
+    std::vector<uint32_t> offsets;      // Source offset reached by the lexer after each token
+    std::vector<uint32_t> newlines;     // Source offsets of all the newline characters
+    uint32_t sourceSize = 0;            // Size of the source in bytes
+    const Interner *interner = nullptr; // Table holding the names of the ID symbols
+
+    // Returns the number of tokens
+    size_t size() const;
+
+    // Returns the position reported by the lexer right after scanning the token at index
+    Position position(size_t index) const;
+
+    // Returns the line of the token at index
+    int line(size_t index) const;
+};
+
+// Utility functions for debugging and pretty-printing:
+
+// Converts a source position to a human-readable string.
+std::string to_string(const Position &position);
+
+// Converts the current state of the Lexer to a human-readable string.
+// Useful for debugging purposes.
+std::string to_string(const Lexer &lexer);
+
+// Converts a token to a human-readable string.
+// Useful for printing tokens during debugging or logging.
+std::string to_string(const Lexer::Token token);
+
+#endif // LEXER_H
@@ -0,0 +1,49 @@
+// File created by fob
+
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "arena.h"
+#include "ast.h"
+#include "interpreter.h"
+
+// The Optimizer rewrites the type checked AST before it is executed or compiled.
+// It folds expressions whose operands are all literals, simplifies algebraic identities
+// (x*1, x+0, !!b, true && e, ...) and removes the branches selected by constant conditions.
+// A rewrite is applied only when it cannot change the behaviour of the program:
+// expressions that would fail at runtime (division by zero) are left in place
+// so they still report the same error at the same position.
+class Optimizer {
+public:
+    // Constructor: new nodes are allocated in the arena owning the AST
+    explicit Optimizer(Arena &arena);
+
+    // Optimizes a whole program in place starting from its root ProgramNode
+    void optimize(Node *node);
+
+private:
+    Arena &arena; // Arena where literals and empty blocks are allocated
+
+    // Helper functions for optimizing the different parts of the AST
+    void optimizeBlock(BlockNode *block);    // Optimizes the statements of a block
+    Node *optimizeStmt(Node *node);          // Returns the optimized statement, nullptr if it does nothing
+    Node *optimizeBody(Node *node);          // Returns the optimized body of a loop or a branch (never nullptr)
+    Node *optimizeExpr(Node *node);          // Returns the optimized expression
+
+    // Folds or simplifies an operation whose operands are already optimized
+    Node *foldMul(MulNode *node);
+    Node *foldAdd(AddNode *node);
+    Node *foldUnary(UnaryNode *node);
+    Node *foldOr(OrNode *node);
+    Node *foldAnd(AndNode *node);
+    Node *foldEquality(EqualityNode *node);
+    Node *foldRel(RelNode *node);
+
+    // Returns true and the value of a node if it is an INT or BOOL literal
+    static bool constantOf(Node *node, Result &value);
+
+    // Creates a literal with the position of the node it replaces
+    Node *makeLiteral(Result value, Node *at);
+};
+
+#endif // OPTIMIZER_H
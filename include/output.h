@@ -0,0 +1,59 @@
+// File created by fob
+
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// The OutputSink collects the text written by print statements.
+// Values are formatted straight into a large buffer that is handed to the underlying stream
+// in blocks, so a program printing millions of lines does not flush the stream on every line.
+class OutputSink {
+public:
+    // When the buffered text is written to the stream. Pending text is written by flush and the destructor,
+    // so a process killed by a signal loses it: only LINE keeps every printed line.
+    enum class FlushPolicy : uint8_t {
+        LINE,   // After every printed line, like std::endl
+        BLOCK,  // Whenever the buffer grows past the block size
+        EXIT    // Only when flush is called explicitly (at the end of the program or on error)
+    };
+
+    // Constructor: the stream must outlive the sink
+    explicit OutputSink(std::ostream &out, FlushPolicy policy = FlushPolicy::BLOCK, size_t blockSize = 64 * 1024);
+
+    // Destructor: writes the pending text
+    ~OutputSink();
+
+    // A sink owns pending text, so it cannot be copied
+    OutputSink(const OutputSink &) = delete;
+    OutputSink &operator=(const OutputSink &) = delete;
+
+    // Changes the flush policy
+    void setPolicy(FlushPolicy policy);
+
+    // Prints an integer followed by a newline
+    void printInt(int value);
+
+    // Prints a boolean (true/false) followed by a newline
+    void printBool(bool value);
+
+    // Writes the pending text to the stream and flushes it
+    void flush();
+
+private:
+    std::ostream &out;  // Stream receiving the text
+    FlushPolicy policy; // Current flush policy
+    size_t blockSize;   // Buffer size that triggers a write with the BLOCK policy
+    std::string buffer; // Text not written yet
+
+    // Terminates a printed line and applies the flush policy
+    void endLine();
+};
+
+// Parses the name of a flush policy (line, block or exit), throws if it is unknown
+OutputSink::FlushPolicy parseFlushPolicy(const std::string &name);
+
+#endif // OUTPUT_H
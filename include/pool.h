@@ -0,0 +1,42 @@
+// File created by fob
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// The WorkStealingPool runs a set of independent tasks on a fixed number of threads.
+// The tasks are dealt to the workers up front, each worker takes its own tasks from the front of its
+// queue and, once the queue is empty, steals from the back of the queue of another worker: a few long
+// tasks never leave the other threads idle while short tasks are still waiting behind them.
+class WorkStealingPool {
+public:
+    // Constructor: threads is the number of workers (0 uses one per hardware thread)
+    explicit WorkStealingPool(unsigned threads = 0);
+
+    // Returns the number of workers
+    unsigned size() const;
+
+    // Runs task(0) ... task(count - 1) on the workers (the calling thread is one of them) and returns
+    // once all of them have finished. If tasks throw, the first exception is rethrown at the end.
+    void run(size_t count, const std::function<void(size_t)> &task);
+
+private:
+    // Tasks waiting to run on a worker
+    struct Queue {
+        std::mutex mutex;           // Protects the tasks, shared with the thieves
+        std::deque<size_t> tasks;   // Indices of the tasks
+    };
+
+    unsigned threads; // Number of workers
+
+    // Takes the next task of a worker: its own first task, or the last task of another worker.
+    // Returns false when every queue is empty (no task is ever added once the run started).
+    static bool take(std::vector<Queue> &queues, unsigned self, size_t &index);
+};
+
+#endif // POOL_H
@@ -0,0 +1,89 @@
+// File created by fob
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "ast.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+
+// The Profiler collects the number of executions and the time spent in each statement node run by
+// the tree-walking Interpreter (iec --profile) and reports the hottest source lines and loops.
+// The self time of a statement excludes the time spent in the statements nested in it.
+class Profiler {
+public:
+    // Times a statement for as long as the scope is alive.
+    // Scope<false> is empty, so the interpreter instantiated without profiling pays nothing.
+    template <bool Enabled>
+    class Scope;
+
+    // Returns whether no statement has been recorded
+    bool empty() const;
+
+    // Returns the number of statements executed so far
+    uint64_t executed() const;
+
+    // Prints the hottest lines (by self time) and loops (by total time), at most limit of each
+    void report(std::ostream &out, size_t limit = 10) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Statistics of a statement node, with the details of the node needed by the report
+    // (the report may be printed once the AST is gone)
+    struct Stats {
+        int line = 0;                       // Source line where the statement starts
+        NodeKind kind = NodeKind::BLOCK;    // Kind of the statement
+        const Node *body = nullptr;         // Body of a loop statement
+        uint64_t count = 0;                 // Number of executions
+        uint64_t selfTime = 0;              // Nanoseconds spent in the statement itself
+        uint64_t totalTime = 0;             // Nanoseconds spent in the statement and in the nested ones
+    };
+
+    std::unordered_map<const Node *, Stats> stats; // Statistics indexed by statement node
+    uint64_t childTime = 0;                         // Time of the statements completed inside the running one
+
+    // Returns the statistics of a statement, recording its details the first time
+    Stats &statsOf(const Node *node);
+};
+
+// Scope of a statement run without profiling
+template <>
+class Profiler::Scope<false> {
+public:
+    Scope(Profiler *, const Node *) {}
+};
+
+// Scope of a statement run with profiling: the nested statements add their time to childTime,
+// which is subtracted from the time of the statement to get its self time
+template <>
+class Profiler::Scope<true> {
+public:
+    Scope(Profiler *profiler, const Node *node) : profiler(profiler), node(node), savedChildTime(profiler->childTime), start(Clock::now()) {
+        profiler->childTime = 0;
+    }
+
+    ~Scope() {
+        uint64_t elapsed = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        Stats &entry = profiler->statsOf(node);
+
+        entry.count++;
+        entry.totalTime += elapsed;
+        entry.selfTime += elapsed - profiler->childTime;
+        profiler->childTime = savedChildTime + elapsed;
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    Profiler *profiler;         // Profiler receiving the statistics
+    const Node *node;           // Statement being timed
+    uint64_t savedChildTime;    // childTime of the enclosing statement
+    Clock::time_point start;    // Start of the statement
+};
+
+#endif // PROFILER_H
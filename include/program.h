@@ -0,0 +1,65 @@
+// File created by fob
+
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+#include "arena.h"
+#include "ast.h"
+#include "cache.h"
+#include "output.h"
+#include "profiler.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// A Program is a source lexed, parsed, checked and optimized once, the entry point of the iec library.
+// It is immutable once built: the bytecode and the machine code are compiled the first time an engine
+// needs them, and a run only reads them, keeping its variables, registers and output in its own state.
+// The same Program can be run any number of times, from several threads at once.
+class Program {
+public:
+    // Engines able to run a program, they print the same text and raise the same errors
+    enum class Engine : uint8_t {
+        INTERPRETER,    // Tree-walking Interpreter
+        VM,             // Bytecode VM
+        JIT             // x86-64 machine code (the VM where the JIT is not available)
+    };
+
+    // Builds a program from a source text, throws std::runtime_error on lexical, syntax and type errors
+    static Program fromSource(std::string_view source);
+
+    // Builds a program from a source file. With a cache the checked tree is loaded from its cache file,
+    // or stored in it when the file is missing or stale.
+    static Program fromFile(const std::string &path, const ProgramCache *cache = nullptr);
+
+    // Runs every pass following the Parser on a parsed tree, in place: resolution, type checking (which
+    // throws std::runtime_error on type errors), folding, initialization and range analyses, loop-invariant
+    // code motion and vectorization. New nodes are allocated in the arena of the parser.
+    static void analyze(Node *tree, Arena &arena);
+
+    // A Program owns its tree, it can be moved but not copied
+    Program(Program &&other) noexcept;
+    Program &operator=(Program &&other) noexcept;
+    ~Program();
+
+    // Runs the program on an engine, print statements write to the sink (which the caller flushes).
+    // Runtime errors are thrown as std::runtime_error. With a profiler (interpreter only) every
+    // statement is timed, a profiler must not be shared by concurrent runs.
+    void run(OutputSink &output, Engine engine = Engine::VM, Profiler *profiler = nullptr) const;
+
+    // Returns the checked and optimized tree
+    const Node &tree() const;
+
+private:
+    // Tree, names, bytecode and machine code (defined in program.cpp)
+    struct Impl;
+
+    std::unique_ptr<Impl> impl;
+
+    // Constructor: used by the factories
+    explicit Program(std::unique_ptr<Impl> impl);
+};
+
+#endif // PROGRAM_H
@@ -0,0 +1,69 @@
+// File created by fob
+
+#ifndef RANGEANALYSIS_H
+#define RANGEANALYSIS_H
+
+#include "ast.h"
+
+#include <vector>
+
+// The RangeAnalysis is a forward dataflow pass run on the type checked (and optimized) AST.
+// It computes an interval of the possible values of each integer variable at each statement,
+// narrowing it with the conditions of the ifs and loops that guard the statement, and clears
+// ArrayAccessNode::checkBounds on the accesses whose index always fits the array, which is the
+// case of the usual induction loops: i = 0; while (i < N) { ... a[i] ...; i = i + 1; }
+// The size of an array is the smallest size it is declared with anywhere in the program,
+// since the runtime array always comes from one of its declarations.
+class RangeAnalysis {
+public:
+    // Analyzes a whole program starting from its root ProgramNode
+    void analyze(Node *node);
+
+private:
+    // Interval of the values an integer can hold, always within the int limits
+    struct Range {
+        long long low;  // Smallest possible value
+        long long high; // Largest possible value
+    };
+
+    // Facts holding at a program point
+    struct State {
+        std::vector<Range> ranges;  // Values of the scalar slots
+        bool reachable = true;      // False after a break (the following code never runs)
+    };
+
+    // How the body of a loop changes a variable from one iteration to the next
+    enum class Step : uint8_t { NONE, INCREASING, DECREASING, ANY };
+
+    State state;                    // Facts at the current program point
+    std::vector<State> breakStates; // Facts at the breaks of each enclosing loop
+    std::vector<int> arraySizes;    // Smallest declared size of each array slot (0 for scalars)
+
+    // Returns the range holding any int value
+    static Range anyInt();
+
+    // Returns the range [low, high], or any int value when the bounds do not fit an int (the operation may wrap)
+    static Range rangeOf(long long low, long long high);
+
+    // Widens the ranges of a state to also hold the values of another one (the join of two paths)
+    static void merge(State &into, const State &from);
+
+    // Returns the variable read by an expression, if it is a plain integer variable
+    static IdNode *variableOf(Node *node);
+
+    // Records in sizes the smallest size each array is declared with inside a statement
+    static void collectSizes(Node *node, std::vector<int> &sizes);
+
+    // Records in steps how the assignments and declarations inside a statement change each variable
+    static void collectSteps(Node *node, std::vector<Step> &steps);
+
+    // Helper functions for analyzing the different parts of the AST
+    void analyzeBlock(Node *node);          // Analyzes the declarations and statements of a block
+    void analyzeStmt(Node *node);           // Analyzes a single statement
+    void analyzeLoopHead(Node *body);       // Moves the state to the head of a loop with the given body
+    bool analyzeBackEdge(State &head);      // Widens a loop head that does not hold the state at the end of the body
+    Range analyzeExpr(Node *node);          // Analyzes an expression and returns the range of its value
+    void refine(Node *condition);           // Narrows the state with a condition known to be true
+};
+
+#endif // RANGEANALYSIS_H
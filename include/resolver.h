@@ -0,0 +1,66 @@
+// File created by fob
+
+#ifndef RESOLVER_H
+#define RESOLVER_H
+
+#include "ast.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The Resolver is the semantic pass run after the Parser.
+// Variables live in a single flat namespace where executing a declaration replaces the variable of that
+// name, so a name may stand for variables of different types over the run (a name declared as int and
+// declared again as boolean in a nested or sibling block). Each name and declared kind (base type and
+// shape) is bound to a numeric slot: the slot is stored in each IdNode, ArrayAccessNode and DeclNode and
+// the runtime keeps the variables in a flat array indexed by it, turning every access into an indexed load.
+// An access takes the slot of the kind of the declarations that may reach it. When declarations of
+// different kinds reach it, the type of the access would depend on the path taken and it is rejected.
+class Resolver {
+public:
+    // Resolves all the identifiers of a program and fills ProgramNode::variables with the slot names
+    void resolve(Node *node);
+
+private:
+    // Kinds of declarations, one bit each in the masks below
+    static constexpr int KINDS = 4; // int, boolean, int array, boolean array
+    static constexpr int UNDECLARED = KINDS; // Slot of the uses of a symbol met before any of its declarations
+
+    ProgramNode *program = nullptr;             // Program being resolved
+    std::vector<int> slots;                     // Slots indexed by symbol * (KINDS + 1) + kind (-1 when not assigned yet)
+    std::vector<uint8_t> declared;              // Kinds each symbol is declared with in the program
+    std::vector<uint8_t> firstKind;             // Kind of the first declaration of each symbol
+    std::vector<int> tracked;                   // Index in reaching of the symbols declared with several kinds, -1 otherwise
+    std::vector<uint8_t> reaching;              // Kinds of the declarations that may reach the current point, by tracked symbol
+    std::vector<std::vector<uint8_t>> breaks;   // Declarations reaching the breaks of each enclosing loop
+
+    // Returns the slot of a symbol for a kind, allocating a new one the first time it is seen
+    int slotOf(int symbol, int kind, std::string_view name);
+
+    // Returns the slot a use of a symbol refers to, from the declarations reaching it
+    int useOf(Node *node, int symbol, std::string_view name);
+
+    // Resolves the whole program once
+    void resolvePass();
+
+    // Helper functions for resolving the different parts of the AST
+    void resolveBlock(Node *node);    // Resolves a block of code
+    void resolveDecls(Node *node);    // Resolves variable declarations
+    void resolveStmts(Node *node);    // Resolves a list of statements
+    void resolveStmt(Node *node);     // Resolves a single statement
+    void resolveLoop(Node *node);     // Resolves a loop, until the declarations reaching its body are known
+    void resolveExpr(Node *node);     // Resolves an expression or a location
+
+    // Returns the kind of a declaration
+    static int kindOf(DeclNode *decl);
+
+    // Adds the declarations of a state to another one
+    static void join(std::vector<uint8_t> &into, const std::vector<uint8_t> &from);
+
+    // Throws a semantic error with a specific message related to a node
+    static void throwError(const std::string &message, Node *node);
+};
+
+#endif // RESOLVER_H
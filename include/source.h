@@ -0,0 +1,36 @@
+// File created by fob
+
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// The SourceFile gives read-only access to the whole content of a source file.
+// On POSIX systems the file is memory-mapped so the Lexer can scan it in place
+// without copying it, elsewhere it is read into memory. Only regular files are
+// accepted: directories, pipes and devices are rejected as unreadable.
+class SourceFile {
+public:
+    // Constructor: opens and maps the file, throws if it is not a readable regular file.
+    explicit SourceFile(const std::string &path);
+
+    // Destructor: unmaps the file.
+    ~SourceFile();
+
+    // A source file owns its mapping, so it cannot be copied.
+    SourceFile(const SourceFile &) = delete;
+    SourceFile &operator=(const SourceFile &) = delete;
+
+    // Returns the content of the file, valid as long as the SourceFile is alive.
+    std::string_view text() const;
+
+private:
+    const char *data = nullptr; // First byte of the content
+    size_t size = 0;            // Size of the content in bytes
+    bool mapped = false;        // Flag indicating whether data points to a memory mapping
+    std::string buffer;         // Content of the file when it is not mapped
+};
+
+#endif // SOURCE_H
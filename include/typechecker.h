@@ -0,0 +1,45 @@
+// File created by fob
+
+#ifndef TYPECHECKER_H
+#define TYPECHECKER_H
+
+#include "ast.h"
+
+#include <string>
+#include <vector>
+
+// The TypeChecker is the semantic pass run after the Resolver.
+// The types of the language are fully static: the Resolver binds each access to a slot whose
+// declarations all have the same base type and shape, so every expression has a single type known
+// before execution.
+// The checker rejects ill-typed programs and stores the type of each expression in Node::valueType,
+// which lets the Interpreter and the Compiler evaluate without checking types at runtime.
+class TypeChecker {
+public:
+    // Checks a whole program starting from its root ProgramNode (the program must be resolved)
+    void check(Node *node);
+
+private:
+    // Declared type of a variable slot
+    struct SlotType {
+        ValueType type = ValueType::UNKNOWN; // Base type (UNKNOWN while no declaration was found)
+        bool isArray = false;                // Flag indicating whether the variable is an array
+        DeclNode *decl = nullptr;            // First declaration of the variable
+    };
+
+    std::vector<SlotType> slots; // Declared types indexed by slot
+
+    // Records the declarations of a block and of its nested statements
+    void collectDecls(Node *node);
+
+    // Helper functions for checking the different parts of the AST
+    void checkBlock(Node *node);         // Checks the statements of a block
+    void checkStmt(Node *node);          // Checks a single statement
+    ValueType checkExpr(Node *node);     // Checks an expression and returns its type
+    const SlotType &checkVariable(Node *node, int slot, std::string_view id, bool isArray); // Checks a variable access
+
+    // Throws a type error with a specific message related to a node
+    [[noreturn]] static void throwError(const std::string &message, Node *node);
+};
+
+#endif // TYPECHECKER_H
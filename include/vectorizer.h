@@ -0,0 +1,57 @@
+// File created by fob
+
+#ifndef VECTORIZER_H
+#define VECTORIZER_H
+
+#include "arena.h"
+#include "ast.h"
+#include "vectorloop.h"
+
+#include <vector>
+
+// The Vectorizer finds the counted loops whose iterations only work on the elements at the index
+// of the loop and attaches a VectorLoop to them (WhileNode::vector), which the engines run before
+// the loop. It runs last, on the proven reads of the InitAnalysis. A loop is vectorized when:
+// - its condition is i < n or i <= n, with n a literal or a proven variable the loop does not write,
+// - its body is a block without declarations ending with i = i + 1,
+// - the other statements are a[i] = e with e an integer expression, b[i] = x op y with b a boolean
+//   array and op a comparison of integer expressions, b[i] = true or false, or s = s + e and
+//   s = s - e (reductions),
+// - the expressions only add, subtract, multiply and negate literals, i, elements of integer arrays
+//   at index i and proven variables that the loop does not write.
+// Those operations can never fail, so the kernel raises no error of its own: the errors of the
+// loop (undeclared arrays, indexes out of bounds, uninitialized elements) are left to the loop.
+class Vectorizer {
+public:
+    // Constructor: the kernels are allocated in the arena owning the AST
+    explicit Vectorizer(Arena &arena);
+
+    // Vectorizes the loops of a whole program starting from its root ProgramNode
+    void vectorize(Node *node);
+
+private:
+    Arena &arena;               // Arena where the kernels are allocated
+    VectorLoop loop;            // Kernel being built
+    std::vector<int> written;   // Variables written by the loop being vectorized (i and the reductions)
+    std::vector<int> stored;    // Arrays already stored by the statements of an iteration
+
+    // Walks the statements down to the innermost loops
+    void vectorizeStmt(Node *node);
+
+    // Builds the kernel of a while loop, returns false when the loop does not have the required form
+    bool buildLoop(WhileNode *whileNode);
+
+    // Adds the operations of a statement of the loop body
+    bool buildStmt(Node *node);
+
+    // Adds the operations computing an integer expression, returns its temporary or -1
+    int buildExpr(Node *node);
+
+    // Adds an operation and returns its temporary
+    int emit(VectorLoop::Op op, int b = 0, int c = 0);
+
+    // Checks if an expression is a proven read of the induction variable
+    bool isCounter(Node *node) const;
+};
+
+#endif // VECTORIZER_H
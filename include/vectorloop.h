@@ -0,0 +1,83 @@
+// File created by fob
+
+#ifndef VECTORLOOP_H
+#define VECTORLOOP_H
+
+#include "interpreter.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A VectorLoop runs many iterations of a counted loop over integer arrays at once:
+//     while (i < n) { c[i] = a[i] * k + b[i]; m[i] = a[i] < b[i]; s = s + a[i]; i = i + 1; }
+// Every element is accessed at index i, so an iteration only touches its own elements and the
+// statements can run one after the other on strips of consecutive elements, with SIMD kernels
+// (AVX2, SSE4.1 or plain C++, selected once from the features of the CPU).
+// The kernel only runs the iterations that cannot fail: the ones where every array is declared,
+// every index is in bounds and every element read is initialized. It then leaves i on the first
+// iteration left, which the loop runs as usual: it raises the same error at the same point, or
+// just ends the loop. The operations wrap on overflow as the scalar ones do.
+class VectorLoop {
+public:
+    // Operations of the kernel, they work on temporaries t holding a strip of elements
+    enum class Op : uint8_t {
+        ELEMENT,    // t[a] = v[b][i], elements of an integer array
+        SCALAR,     // t[a] = v[b], variable not written by the loop
+        CONSTANT,   // t[a] = int b
+        COUNTER,    // t[a] = i
+        ADD,        // t[a] = t[b] + t[c]
+        SUB,        // t[a] = t[b] - t[c]
+        MUL,        // t[a] = t[b] * t[c]
+        EQ,         // t[a] = t[b] == t[c] (0 or 1)
+        NEQ,        // t[a] = t[b] != t[c]
+        LESS,       // t[a] = t[b] < t[c]
+        LESSEQ,     // t[a] = t[b] <= t[c]
+        GREATER,    // t[a] = t[b] > t[c]
+        GREATEREQ,  // t[a] = t[b] >= t[c]
+        STORE,      // v[a][i] = t[b], integer array (c = 1 when t[b] is computed straight into it)
+        STORE_BOOL, // v[a][i] = t[b], boolean array
+        SUM,        // v[a] = v[a] + t[b], or v[a] - t[b] when c = 1 (reduction into a variable)
+    };
+
+    // Single operation, the operands are laid out next to each Op
+    struct Operation {
+        Op op;  // Operation code
+        int a;  // First operand
+        int b;  // Second operand
+        int c;  // Third operand
+    };
+
+    // Largest number of temporaries of a kernel
+    static constexpr int MAX_TEMPORARIES = 16;
+
+    // Number of elements of a strip (a multiple of 64, so the strips of a boolean array fill whole words)
+    static constexpr int STRIP = 256;
+
+    int counter = -1;               // Slot of the induction variable i
+    int bound = -1;                 // Slot of the bound of i, or -1 when it is the constant boundValue
+    int boundValue = 0;             // Constant bound of i
+    bool inclusive = false;         // The condition is i <= bound instead of i < bound
+    int temporaries = 0;            // Number of temporaries
+    std::vector<Operation> code;    // Operations of an iteration, in the order of the statements
+    std::vector<int> intArrays;     // Integer arrays accessed
+    std::vector<int> boolArrays;    // Boolean arrays written
+    std::vector<int> reads;         // Integer arrays read before an iteration writes them
+
+    // Runs the iterations that cannot fail, leaving i on the first iteration the loop has to run
+    void run(SymbolMap &symbolMap) const;
+
+    // Selects the kernels of an instruction set: "avx2", "sse4.1", "scalar" or "auto" (the best one
+    // this CPU supports, the default). Returns false when the name is unknown or the CPU lacks it.
+    static bool useInstructionSet(const std::string &name);
+
+    // Returns the name of the instruction set of the kernels in use
+    static const char *instructionSet();
+
+private:
+    // Runs the operations on the strip of count elements starting at index, the temporaries point
+    // to their elements (in an array or in a buffer) and the buffers hold the computed ones
+    void runStrip(SymbolMap &symbolMap, int index, int count, const int32_t **temporary, int32_t (*buffers)[STRIP]) const;
+};
+
+#endif // VECTORLOOP_H
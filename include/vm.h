@@ -0,0 +1,36 @@
+// File created by fob
+
+#ifndef VM_H
+#define VM_H
+
+#include "bytecode.h"
+#include "interpreter.h"
+
+#include <string>
+#include <vector>
+
+// Register based virtual machine executing the bytecode produced by the Compiler.
+// It follows the same semantics (and error messages) as the tree-walking Interpreter.
+// The chunk must come from a type checked program: instructions never check the types of their operands.
+class VM {
+public:
+    // Constructor: PRINT instructions write to the given sink
+    explicit VM(OutputSink &output);
+
+    // Executes a compiled chunk from its first instruction until HALT
+    void run(const Chunk &chunk);
+
+    // Executes the instruction at pc when it accesses the variables, declares them or prints: the instructions
+    // the JIT has no machine code template for, which run here for both engines (r are the registers)
+    static void execute(const Chunk &chunk, size_t pc, SymbolMap &symbolMap, int *r, OutputSink &output);
+
+    // Throws a runtime error with a specific message related to the instruction at pc
+    [[noreturn]] static void throwError(const std::string &message, const Chunk &chunk, size_t pc);
+
+private:
+    SymbolMap symbolMap;             // Program variables indexed by slot
+    std::vector<int> registers;      // Registers holding intermediate results (booleans as 0 or 1)
+    OutputSink &output;              // Destination of the PRINT instructions
+};
+
+#endif // VM_H
@@ -1,34 +1,249 @@
-// File created by fob
-
-#include "include/interpreter.h"
-#include "include/lexer.h"
-#include "include/parser.h"
-
-int main(int argc, char* argv[]) {
-    try {
-        if (argc != 2) {
-            std::string errMsg = "Error: Expected 2 arguments found " + std::to_string(argc);
-            throw std::runtime_error(errMsg);
-        }
-
-        std::ifstream file(argv[1]);
-
-        if (!file.is_open()) {
-            std::string errMsg = "Error: Unable to open file " + ((std::string) argv[1]);
-            throw std::runtime_error(errMsg);
-        }
-
-        Lexer lexer(file);
-        Parser parser(lexer);
-        Interpreter interpreter;
-
-        interpreter.interpret(parser.parse());
-
-        std::cout.flush();
-        file.close();
-    } catch (const std::exception& e) {
-        std::cerr << e.what() << std::endl;
-    }
-
-    return 0;
-}
+// File created by fob
+
+#include "include/cache.h"
+#include "include/output.h"
+#include "include/pool.h"
+#include "include/profiler.h"
+#include "include/program.h"
+#include "include/vectorloop.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+// Command line options
+struct Options {
+    std::vector<std::string> paths; // Source files to run (exactly one outside of batch mode)
+    bool batch = false; // Run many source files on a thread pool, printing their outputs in order
+    unsigned jobs = 0;  // Threads of the batch mode (0: one per hardware thread)
+    bool useVM = false; // Run the program on the bytecode VM instead of the tree-walking interpreter
+    bool useJIT = false; // Run the program as x86-64 machine code (on the VM where the JIT is not available)
+    bool dumpOptimized = false; // Print the optimized AST instead of running the program
+    bool profile = false; // Time the statements of the interpreter and report the hottest lines and loops
+    bool cache = false; // Load the checked program from a cache file, writing it when it is missing or stale
+    std::string cacheDirectory; // Directory of the cache files (empty: next to the source)
+    OutputSink::FlushPolicy flush = OutputSink::FlushPolicy::BLOCK; // When printed text reaches stdout (text still pending is lost if the process is killed)
+};
+
+// Usage of the command line, reported when it is wrong
+static const char *USAGE = "Error: Usage: iec [--vm] [--jit] [--flush=line|block|exit] [--profile] [--cache[=<dir>]] [--simd=<isa>] [--dump-optimized] <file>\n"
+                           "       iec --batch [--jobs=<n>] [--manifest=<file>] [--vm] [--jit] [--cache[=<dir>]] [--simd=<isa>] [--dump-optimized] <file>...\n"
+                           "       --flush=block (the default) and exit hold printed text in memory: it is written at the end or\n"
+                           "       on a runtime error, but lost if the process is killed; --flush=line writes every line at once";
+
+// Adds the source files listed in a manifest, one per line. Blank lines and lines starting with #
+// are skipped, relative paths are relative to the directory of the manifest.
+void readManifest(const std::string &manifest, std::vector<std::string> &paths) {
+    std::ifstream file(manifest);
+    if (!file) {
+        throw std::runtime_error("Error: Cannot open manifest " + manifest);
+    }
+
+    std::filesystem::path base = std::filesystem::path(manifest).parent_path();
+    std::string line;
+
+    while (std::getline(file, line)) {
+        size_t begin = line.find_first_not_of(" \t\r");
+        size_t end = line.find_last_not_of(" \t\r");
+
+        if (begin == std::string::npos || line[begin] == '#') {
+            continue;
+        }
+
+        std::filesystem::path path = line.substr(begin, end - begin + 1);
+        paths.push_back(path.is_absolute() ? path.string() : (base / path).string());
+    }
+}
+
+// Parses the command line, see USAGE
+Options parseOptions(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--vm") {
+            options.useVM = true;
+        } else if (arg == "--jit") {
+            options.useJIT = true;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--cache") {
+            options.cache = true;
+        } else if (arg.rfind("--cache=", 0) == 0) {
+            options.cache = true;
+            options.cacheDirectory = arg.substr(8);
+        } else if (arg == "--dump-optimized") {
+            options.dumpOptimized = true;
+        } else if (arg.rfind("--flush=", 0) == 0) {
+            options.flush = parseFlushPolicy(arg.substr(8));
+        } else if (arg == "--batch") {
+            options.batch = true;
+        } else if (arg.rfind("--jobs=", 0) == 0) {
+            char *end = nullptr;
+            unsigned long jobs = std::strtoul(arg.c_str() + 7, &end, 10);
+
+            if (arg.size() == 7 || *end != '\0' || jobs == 0 || jobs > 1024) {
+                throw std::runtime_error("Error: Invalid number of jobs " + arg.substr(7));
+            }
+            options.jobs = (unsigned) jobs;
+        } else if (arg.rfind("--simd=", 0) == 0) {
+            // Kernels of the vectorized loops: avx2, sse4.1 or scalar (default: the best one of the CPU)
+            if (!VectorLoop::useInstructionSet(arg.substr(7))) {
+                throw std::runtime_error("Error: Instruction set " + arg.substr(7) + " is not available on this machine");
+            }
+        } else if (arg.rfind("--manifest=", 0) == 0) {
+            options.batch = true;
+            readManifest(arg.substr(11), options.paths);
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            throw std::runtime_error("Error: Unknown option " + arg);
+        } else if (options.batch || options.paths.empty()) {
+            options.paths.push_back(arg);
+        } else {
+            throw std::runtime_error("Error: Unexpected argument " + arg);
+        }
+    }
+
+    if (options.paths.empty() || (!options.batch && options.paths.size() > 1)) {
+        throw std::runtime_error(USAGE);
+    }
+
+    if (options.profile && (options.useVM || options.useJIT)) {
+        throw std::runtime_error("Error: --profile times the statements of the interpreter, it cannot be combined with --vm or --jit");
+    }
+
+    if (options.profile && options.batch) {
+        throw std::runtime_error("Error: --profile reports a single program, it cannot be combined with --batch");
+    }
+
+    return options;
+}
+
+// Runs a source file with the engine chosen by the options. The program prints to the output,
+// --dump-optimized prints the tree to the dump stream.
+void runFile(const Options &options, const std::string &path, OutputSink &output, std::ostream &dump, Profiler *profiler) {
+    ProgramCache cache(options.cacheDirectory);
+    Program program = Program::fromFile(path, options.cache ? &cache : nullptr);
+
+    if (options.dumpOptimized) {
+        dump << program.tree();
+    } else if (options.useJIT) {
+        program.run(output, Program::Engine::JIT);
+    } else if (options.useVM) {
+        program.run(output, Program::Engine::VM);
+    } else {
+        program.run(output, Program::Engine::INTERPRETER, profiler);
+    }
+}
+
+// Runs the source files of a batch on a work-stealing pool, each one built as its own Program.
+// The output of a file (followed by its error, if any) is captured and printed under a
+// "==> path <==" header as soon as the files before it are done, so stdout is the same whatever the
+// number of threads. Throughput statistics go to stderr. Returns 1 when a file failed.
+int runBatch(const Options &options) {
+    using Clock = std::chrono::steady_clock;
+
+    // What a file printed and how it went
+    struct Result {
+        std::string text;       // Captured output and error
+        bool done = false;      // The file has finished
+        bool failed = false;    // The file stopped with an error
+        double seconds = 0;     // Time spent on the file
+    };
+
+    const std::vector<std::string> &paths = options.paths;
+    std::vector<Result> results(paths.size());
+    std::mutex mutex;
+    size_t next = 0;    // First file not printed yet
+    size_t failures = 0;
+    uintmax_t bytes = 0;
+    WorkStealingPool pool(options.jobs);
+    Clock::time_point start = Clock::now();
+
+    pool.run(paths.size(), [&](size_t index) {
+        Clock::time_point begin = Clock::now();
+        std::ostringstream text;
+        bool failed = false;
+
+        {
+            OutputSink output(text, OutputSink::FlushPolicy::EXIT);
+
+            try {
+                runFile(options, paths[index], output, text, nullptr);
+                output.flush();
+            } catch (const std::exception &e) {
+                output.flush();
+                text << e.what() << "\n";
+                failed = true;
+            }
+        }
+
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(paths[index], error);
+        std::lock_guard<std::mutex> lock(mutex);
+        Result &result = results[index];
+
+        result.text = text.str();
+        result.done = true;
+        result.failed = failed;
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        failures += failed;
+        bytes += error ? 0 : size;
+
+        for (; next < results.size() && results[next].done; next++) {
+            std::cout << "==> " << paths[next] << " <==\n" << results[next].text;
+            results[next].text = std::string();
+        }
+        std::cout.flush();
+    });
+
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    double busy = 0;
+    for (const Result &result : results) {
+        busy += result.seconds;
+    }
+
+    std::ostringstream stats;
+    stats << std::fixed << std::setprecision(3)
+          << "Batch: " << paths.size() << " files, " << failures << " failed, "
+          << std::min<size_t>(pool.size(), paths.size()) << " threads, " << wall << " s\n"
+          << "       " << std::setprecision(1) << paths.size() / wall << " files/s, "
+          << bytes / 1e6 / wall << " MB/s of source, "
+          << std::setprecision(2) << busy / wall << " files running on average\n";
+    std::cerr << stats.str();
+
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Created before anything can fail, so the text printed before an error always precedes it
+    OutputSink output(std::cout);
+    Profiler profiler;
+
+    try {
+        Options options = parseOptions(argc, argv);
+
+        if (options.batch) {
+            return runBatch(options);
+        }
+
+        output.setPolicy(options.flush);
+        runFile(options, options.paths[0], output, std::cout, options.profile ? &profiler : nullptr);
+        output.flush();
+    } catch (const std::exception& e) {
+        output.flush();
+        std::cerr << e.what() << std::endl;
+    }
+
+    // The report also covers a program stopped by an error
+    if (!profiler.empty()) {
+        profiler.report(std::cerr);
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+// File created by fob
+
+#include "../include/arena.h"
+
+#include <cstdint>
+
+// Constructor: no memory is requested until the first allocation
+Arena::Arena(size_t blockSize) : blockSize(blockSize) {}
+
+// Destructor: releases every object allocated in the arena
+Arena::~Arena() {
+    clear();
+}
+
+// Move constructor: takes the ownership of all the blocks of the other arena
+Arena::Arena(Arena &&other) noexcept
+    : blockSize(other.blockSize), blocks(std::move(other.blocks)), current(other.current),
+      remaining(other.remaining), used(other.used), finalizers(std::move(other.finalizers)) {
+    other.blocks.clear();
+    other.finalizers.clear();
+    other.current = nullptr;
+    other.remaining = 0;
+    other.used = 0;
+}
+
+// Move assignment: releases the current content and takes the one of the other arena
+Arena &Arena::operator=(Arena &&other) noexcept {
+    if (this != &other) {
+        clear();
+        blockSize = other.blockSize;
+        blocks = std::move(other.blocks);
+        current = other.current;
+        remaining = other.remaining;
+        used = other.used;
+        finalizers = std::move(other.finalizers);
+
+        other.blocks.clear();
+        other.finalizers.clear();
+        other.current = nullptr;
+        other.remaining = 0;
+        other.used = 0;
+    }
+    return *this;
+}
+
+// Bumps the current pointer, opening a new block when the current one is exhausted
+void *Arena::allocate(size_t size, size_t alignment) {
+    size_t padding = (alignment - (reinterpret_cast<uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+
+    if (!current || padding + size > remaining) {
+        // Oversized requests get a block of their own
+        size_t newBlockSize = size + alignment > blockSize ? size + alignment : blockSize;
+
+        blocks.emplace_back(new char[newBlockSize]);
+        current = blocks.back().get();
+        remaining = newBlockSize;
+        padding = (alignment - (reinterpret_cast<uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+    }
+
+    char *memory = current + padding;
+    current = memory + size;
+    remaining -= padding + size;
+    used += size;
+
+    return memory;
+}
+
+// Runs the registered destructors in reverse allocation order and frees all the blocks
+void Arena::clear() {
+    for (auto finalizer = finalizers.rbegin(); finalizer != finalizers.rend(); ++finalizer) {
+        finalizer->destroy(finalizer->object);
+    }
+
+    finalizers.clear();
+    blocks.clear();
+    current = nullptr;
+    remaining = 0;
+    used = 0;
+}
+
+// Returns the number of bytes handed out by the arena
+size_t Arena::bytesUsed() const {
+    return used;
+}
@@ -0,0 +1,70 @@
+// File created by fob
+
+#include "../include/bytecode.h"
+
+// Converts an OpCode enum to its string representation.
+std::string to_string(OpCode op) {
+    switch (op) {
+        case OpCode::LOAD_INT:      return "LOAD_INT";
+        case OpCode::LOAD_BOOL:     return "LOAD_BOOL";
+        case OpCode::LOAD_VAR:      return "LOAD_VAR";
+        case OpCode::LOAD_VAR_FAST: return "LOAD_VAR_FAST";
+        case OpCode::LOAD_ELEM:     return "LOAD_ELEM";
+        case OpCode::LOAD_ELEM_FAST: return "LOAD_ELEM_FAST";
+        case OpCode::STORE_VAR:     return "STORE_VAR";
+        case OpCode::STORE_VAR_FAST: return "STORE_VAR_FAST";
+        case OpCode::STORE_ELEM:    return "STORE_ELEM";
+        case OpCode::STORE_ELEM_FAST: return "STORE_ELEM_FAST";
+        case OpCode::INC_VAR:       return "INC_VAR";
+        case OpCode::ADD_ELEM:      return "ADD_ELEM";
+        case OpCode::ADD_ELEM_FAST: return "ADD_ELEM_FAST";
+        case OpCode::VECTOR_LOOP:   return "VECTOR_LOOP";
+        case OpCode::CHECK_DECLARED: return "CHECK_DECLARED";
+        case OpCode::DECLARE:       return "DECLARE";
+        case OpCode::ADD:           return "ADD";
+        case OpCode::SUB:           return "SUB";
+        case OpCode::MUL:           return "MUL";
+        case OpCode::DIV:           return "DIV";
+        case OpCode::ADD_BOOL:      return "ADD_BOOL";
+        case OpCode::SUB_BOOL:      return "SUB_BOOL";
+        case OpCode::MUL_BOOL:      return "MUL_BOOL";
+        case OpCode::DIV_BOOL:      return "DIV_BOOL";
+        case OpCode::EQ:            return "EQ";
+        case OpCode::NEQ:           return "NEQ";
+        case OpCode::LESS:          return "LESS";
+        case OpCode::LESSEQ:        return "LESSEQ";
+        case OpCode::GREATER:       return "GREATER";
+        case OpCode::GREATEREQ:     return "GREATEREQ";
+        case OpCode::NOT:           return "NOT";
+        case OpCode::NEG:           return "NEG";
+        case OpCode::TO_BOOL:       return "TO_BOOL";
+        case OpCode::JUMP:          return "JUMP";
+        case OpCode::JUMP_IF_FALSE: return "JUMP_IF_FALSE";
+        case OpCode::JUMP_IF_TRUE:  return "JUMP_IF_TRUE";
+        case OpCode::JUMP_IF_LESS:  return "JUMP_IF_LESS";
+        case OpCode::JUMP_IF_LESSEQ: return "JUMP_IF_LESSEQ";
+        case OpCode::JUMP_IF_GREATER: return "JUMP_IF_GREATER";
+        case OpCode::JUMP_IF_GREATEREQ: return "JUMP_IF_GREATEREQ";
+        case OpCode::JUMP_IF_EQ:    return "JUMP_IF_EQ";
+        case OpCode::JUMP_IF_NEQ:   return "JUMP_IF_NEQ";
+        case OpCode::JUMP_IF_LESS_INT: return "JUMP_IF_LESS_INT";
+        case OpCode::JUMP_IF_LESSEQ_INT: return "JUMP_IF_LESSEQ_INT";
+        case OpCode::JUMP_IF_GREATER_INT: return "JUMP_IF_GREATER_INT";
+        case OpCode::JUMP_IF_GREATEREQ_INT: return "JUMP_IF_GREATEREQ_INT";
+        case OpCode::JUMP_IF_EQ_INT: return "JUMP_IF_EQ_INT";
+        case OpCode::JUMP_IF_NEQ_INT: return "JUMP_IF_NEQ_INT";
+        case OpCode::PRINT:         return "PRINT";
+        case OpCode::BREAK:         return "BREAK";
+        case OpCode::HALT:          return "HALT";
+    }
+    return "UNKNOWN";
+}
+
+// Prints one instruction per line preceded by its position
+std::ostream& operator<<(std::ostream& out, const Chunk& chunk) {
+    for (size_t pc = 0; pc < chunk.code.size(); pc++) {
+        const Instruction &instruction = chunk.code[pc];
+        out << pc << ": " << to_string(instruction.op) << " " << instruction.a << " " << instruction.b << " " << instruction.c << "\n";
+    }
+    return out;
+}
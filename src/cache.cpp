@@ -0,0 +1,556 @@
+// File created by fob
+
+#include "../include/cache.h"
+#include "../include/rangeanalysis.h"
+#include "../include/source.h"
+#include "../include/vectorizer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// Payload layout: the variable names (a count, then a length and the bytes of each), then the nodes in
+// pre-order. A node starts with a tag byte (kind | valueType << 5, NO_NODE for a missing child), the
+// difference between its line and the line of the previous node, its column and the number of lines
+// between its start line and its line (0 but for the statements spanning lines), followed by its own
+// fields and its children. Numbers are LEB128 varints, zigzag encoded when they can be negative.
+// Identifiers are stored as their slot: the name is the one of the variable and the symbol (only
+// needed by the Resolver) is the slot itself.
+
+// Tag of a missing child
+static constexpr uint8_t NO_NODE = 0xFF;
+
+// The Writer appends the encoding of a tree to a payload
+class ProgramCache::Writer {
+public:
+    // Constructor: the payload must outlive the writer
+    explicit Writer(std::string &payload) : payload(payload) {}
+
+    // Appends a node followed by its children
+    void node(const Node *node) {
+        if (!node) {
+            byte(NO_NODE);
+            return;
+        }
+
+        byte((uint8_t) ((uint8_t) node->kind | (uint8_t) node->valueType << 5));
+        signedVarint((int64_t) node->line - previousLine);
+        signedVarint(node->column);
+        signedVarint((int64_t) node->line - node->startLine);
+        previousLine = node->line;
+
+        visit(const_cast<Node *>(node), [&](auto *typed) { fields(typed); });
+    }
+
+private:
+    std::string &payload;   // Bytes written so far
+    int previousLine = 0;   // Line of the last node written
+
+    void byte(uint8_t value) {
+        payload.push_back((char) value);
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            byte((uint8_t) (value | 0x80));
+            value >>= 7;
+        }
+        byte((uint8_t) value);
+    }
+
+    void signedVarint(int64_t value) {
+        varint(((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+    }
+
+    void string(std::string_view text) {
+        varint(text.size());
+        payload.append(text.data(), text.size());
+    }
+
+    // Fields and children of each kind of node
+    void fields(const ProgramNode *program) {
+        varint(program->variables.size());
+        for (const std::string &name : program->variables) {
+            string(name);
+        }
+        node(program->block);
+    }
+    void fields(const BlockNode *block) { node(block->decls); node(block->stmts); }
+    void fields(const DeclsNode *decls) { varint(decls->count); for (Node *decl : *decls) node(decl); }
+    void fields(const StmtsNode *stmts) { varint(stmts->count); for (Node *stmt : *stmts) node(stmt); }
+    void fields(const DeclNode *decl) { varint((uint64_t) decl->slot); node(decl->type); }
+    void fields(const BasicTypeNode *basicType) { string(basicType->typeName); }
+    void fields(const ArrayTypeNode *arrayType) { signedVarint(arrayType->arraySize); node(arrayType->type); }
+    void fields(const IdNode *id) { varint((uint64_t) id->slot); byte(id->checked); }
+    void fields(const AssignNode *assign) { node(assign->loc); node(assign->expr); }
+    void fields(const ArrayAccessNode *access) { varint((uint64_t) access->slot); node(access->index); }
+    void fields(const OrNode *orNode) { node(orNode->left); node(orNode->right); }
+    void fields(const AndNode *andNode) { node(andNode->left); node(andNode->right); }
+    void fields(const EqualityNode *equality) { byte(equality->isEqual); node(equality->left); node(equality->right); }
+    void fields(const RelNode *rel) { byte((uint8_t) rel->op); node(rel->left); node(rel->right); }
+    void fields(const AddNode *add) { byte(add->isAddition); node(add->left); node(add->right); }
+    void fields(const MulNode *mul) { byte(mul->isMultiplication); node(mul->left); node(mul->right); }
+    void fields(const UnaryNode *unary) { byte((uint8_t) unary->op); node(unary->operand); }
+    void fields(const FactorNode *factor) {
+        byte((uint8_t) factor->type);
+        signedVarint(factor->intValue);
+        byte(factor->boolValue);
+        node(factor->loc);
+    }
+    void fields(const IfNode *ifNode) { node(ifNode->condition); node(ifNode->ifStmt); }
+    void fields(const IfElseNode *ifElse) { node(ifElse->condition); node(ifElse->ifStmt); node(ifElse->elseStmt); }
+    void fields(const WhileNode *whileNode) { node(whileNode->condition); node(whileNode->body); }
+    void fields(const DoWhileNode *doWhile) { node(doWhile->body); node(doWhile->condition); }
+    void fields(const PrintNode *print) { node(print->expr); }
+    void fields(const BreakNode *) {}
+};
+
+// The Reader rebuilds the nodes from a payload. Every read is checked against the end of the payload and
+// every field against the values the passes can produce, so a damaged file is rejected and never crashes.
+class ProgramCache::Reader {
+public:
+    // Constructor: the nodes are allocated in the arena
+    Reader(std::string_view payload, Arena &arena) : cursor(payload.data()), end(payload.data() + payload.size()), arena(arena) {}
+
+    // Decodes the whole payload, throws if it is damaged
+    Node *program() {
+        uint8_t tag = byte();
+        check(tag == (uint8_t) NodeKind::PROGRAM);
+
+        int startLine;
+        Position position = readPosition(startLine);
+        auto *program = arena.make<ProgramNode>(position, nullptr);
+        program->startLine = startLine;
+        uint64_t count = varint();
+
+        // The names are in place before the nodes refer to them
+        check(count <= (size_t) (end - cursor));
+        for (uint64_t i = 0; i < count; i++) {
+            program->variables.emplace_back(bytes());
+        }
+        variables = &program->variables;
+
+        program->block = child(NodeKind::BLOCK);
+        check(cursor == end);
+
+        return program;
+    }
+
+private:
+    const char *cursor;                                 // Next byte to decode
+    const char *end;                                    // End of the payload
+    Arena &arena;                                       // Arena receiving the nodes
+    const std::vector<std::string> *variables = nullptr; // Variable names of the program, indexed by slot
+    int previousLine = 0;                               // Line of the last node read
+
+    // Rejects the payload when a condition does not hold
+    void check(bool condition) const {
+        if (!condition) {
+            throw std::runtime_error("Error: Damaged cache file");
+        }
+    }
+
+    uint8_t byte() {
+        check(cursor < end);
+
+        return (uint8_t) *cursor++;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+
+        for (int shift = 0;; shift += 7) {
+            check(shift < 64);
+
+            uint8_t next = byte();
+            value |= (uint64_t) (next & 0x7F) << shift;
+            if (!(next & 0x80)) {
+                return value;
+            }
+        }
+    }
+
+    int64_t signedVarint() {
+        uint64_t value = varint();
+
+        return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+    }
+
+    // Reads a number that must fit in an int
+    int integer() {
+        int64_t value = signedVarint();
+
+        check(value >= INT32_MIN && value <= INT32_MAX);
+
+        return (int) value;
+    }
+
+    // Reads a name, the view points into the payload
+    std::string_view bytes() {
+        uint64_t size = varint();
+
+        check(size <= (size_t) (end - cursor));
+
+        std::string_view text(cursor, (size_t) size);
+        cursor += size;
+
+        return text;
+    }
+
+    // Reads a name into the arena, so it outlives the mapping of the file
+    std::string_view string() {
+        std::string_view text = bytes();
+
+        if (text.empty()) {
+            return text;
+        }
+
+        return std::string_view(arena.copyArray(text.data(), text.size()), text.size());
+    }
+
+    // Reads a variable slot, which must belong to the program
+    int slot() {
+        uint64_t slot = varint();
+
+        check(slot < variables->size());
+
+        return (int) slot;
+    }
+
+    // Returns the name of a variable, the view points into the program
+    std::string_view name(int slot) const {
+        return (*variables)[slot];
+    }
+
+    // Reads an enumeration value in [0, count)
+    template <typename T>
+    T enumeration(int count) {
+        uint8_t value = byte();
+
+        check(value < count);
+
+        return (T) value;
+    }
+
+    // Reads the line and the column of a node, and its start line
+    Position readPosition(int &startLine) {
+        int line = (int) (previousLine + signedVarint());
+        int column = integer();
+
+        startLine = (int) (line - signedVarint());
+        previousLine = line;
+
+        return Position{line, column};
+    }
+
+    // Reads a child that must be present and of the given kind
+    Node *child(NodeKind kind) {
+        Node *node = optional();
+
+        check(node && node->kind == kind);
+
+        return node;
+    }
+
+    // Reads a child that must be present (an expression or a statement)
+    Node *required() {
+        Node *node = optional();
+
+        check(node != nullptr);
+
+        return node;
+    }
+
+    // Reads a child that may be missing
+    Node *optional() {
+        uint8_t tag = byte();
+
+        if (tag == NO_NODE) {
+            return nullptr;
+        }
+
+        uint8_t kindValue = tag & 0x1F;
+        uint8_t typeValue = tag >> 5;
+        check(kindValue <= (uint8_t) NodeKind::BREAK && kindValue != (uint8_t) NodeKind::PROGRAM && typeValue <= (uint8_t) ValueType::BOOL);
+
+        NodeKind kind = (NodeKind) kindValue;
+        int startLine;
+        Position position = readPosition(startLine);
+        Node *node = nullptr;
+
+        switch (kind) {
+            case NodeKind::PROGRAM: // Only at the root
+                break;
+            case NodeKind::BLOCK: {
+                Node *decls = optional();
+                Node *stmts = optional();
+
+                check((!decls || decls->kind == NodeKind::DECLS) && (!stmts || stmts->kind == NodeKind::STMTS));
+                node = arena.make<BlockNode>(position, decls, stmts);
+                break;
+            }
+            case NodeKind::DECLS:
+            case NodeKind::STMTS: {
+                uint64_t count = varint();
+                check(count > 0 && count <= (size_t) (end - cursor));
+
+                std::vector<Node *> children;
+                for (uint64_t i = 0; i < count; i++) {
+                    children.push_back(kind == NodeKind::DECLS ? child(NodeKind::DECL) : required());
+                }
+
+                Node **array = arena.copyArray(children.data(), children.size());
+                if (kind == NodeKind::DECLS) {
+                    node = arena.make<DeclsNode>(position, array, children.size());
+                } else {
+                    node = arena.make<StmtsNode>(position, array, children.size());
+                }
+                break;
+            }
+            case NodeKind::DECL: {
+                int declSlot = slot();
+                Node *declType = required();
+
+                check(declType->kind == NodeKind::BASIC_TYPE || declType->kind == NodeKind::ARRAY_TYPE);
+                auto *decl = arena.make<DeclNode>(position, declType, declSlot, name(declSlot));
+                decl->slot = declSlot;
+                node = decl;
+                break;
+            }
+            case NodeKind::BASIC_TYPE:
+                node = arena.make<BasicTypeNode>(position, string());
+                break;
+            case NodeKind::ARRAY_TYPE: {
+                int arraySize = integer();
+                check(arraySize >= 0);
+                node = arena.make<ArrayTypeNode>(position, child(NodeKind::BASIC_TYPE), arraySize);
+                break;
+            }
+            case NodeKind::ID: {
+                int idSlot = slot();
+                auto *id = arena.make<IdNode>(position, idSlot, name(idSlot));
+
+                id->slot = idSlot;
+                id->checked = byte() != 0;
+                node = id;
+                break;
+            }
+            case NodeKind::ASSIGN: {
+                Node *loc = required();
+                check(loc->kind == NodeKind::ID || loc->kind == NodeKind::ARRAY_ACCESS);
+                node = arena.make<AssignNode>(position, loc, required());
+                break;
+            }
+            case NodeKind::ARRAY_ACCESS: {
+                int accessSlot = slot();
+                auto *access = arena.make<ArrayAccessNode>(position, required(), accessSlot, name(accessSlot));
+
+                access->slot = accessSlot;
+                node = access;
+                break;
+            }
+            case NodeKind::OR: {
+                Node *left = required();
+                node = arena.make<OrNode>(position, left, required());
+                break;
+            }
+            case NodeKind::AND: {
+                Node *left = required();
+                node = arena.make<AndNode>(position, left, required());
+                break;
+            }
+            case NodeKind::EQUALITY: {
+                bool isEqual = byte() != 0;
+                Node *left = required();
+                node = arena.make<EqualityNode>(position, left, required(), isEqual);
+                break;
+            }
+            case NodeKind::REL: {
+                auto op = enumeration<RelNode::Op>(4);
+                Node *left = required();
+                node = arena.make<RelNode>(position, left, required(), op);
+                break;
+            }
+            case NodeKind::ADD: {
+                bool isAddition = byte() != 0;
+                Node *left = required();
+                node = arena.make<AddNode>(position, left, required(), isAddition);
+                break;
+            }
+            case NodeKind::MUL: {
+                bool isMultiplication = byte() != 0;
+                Node *left = required();
+                node = arena.make<MulNode>(position, left, required(), isMultiplication);
+                break;
+            }
+            case NodeKind::UNARY: {
+                auto op = enumeration<UnaryNode::Op>(2);
+                node = arena.make<UnaryNode>(position, required(), op);
+                break;
+            }
+            case NodeKind::FACTOR: {
+                auto factorType = enumeration<FactorNode::Type>(3);
+                int intValue = integer();
+                bool boolValue = byte() != 0;
+                Node *loc = optional();
+
+                check((factorType == FactorNode::ID) == (loc != nullptr));
+                check(!loc || loc->kind == NodeKind::ID || loc->kind == NodeKind::ARRAY_ACCESS);
+                node = arena.make<FactorNode>(position, factorType, intValue, boolValue, loc);
+                break;
+            }
+            case NodeKind::IF: {
+                Node *condition = required();
+                node = arena.make<IfNode>(position, condition, required());
+                break;
+            }
+            case NodeKind::IF_ELSE: {
+                Node *condition = required();
+                Node *ifStmt = required();
+                node = arena.make<IfElseNode>(position, condition, ifStmt, required());
+                break;
+            }
+            case NodeKind::WHILE: {
+                Node *condition = required();
+                node = arena.make<WhileNode>(position, condition, required());
+                break;
+            }
+            case NodeKind::DO_WHILE: {
+                Node *body = required();
+                node = arena.make<DoWhileNode>(position, body, required());
+                break;
+            }
+            case NodeKind::PRINT:
+                node = arena.make<PrintNode>(position, required());
+                break;
+            case NodeKind::BREAK:
+                node = arena.make<BreakNode>(position);
+                break;
+        }
+
+        node->valueType = (ValueType) typeValue;
+        node->startLine = startLine;
+
+        return node;
+    }
+};
+
+// Constructor
+ProgramCache::ProgramCache(std::string directory) : directory(std::move(directory)) {}
+
+// Returns the path of the cache file of a source with the given hash
+std::string ProgramCache::pathOf(const std::string &sourcePath, uint64_t sourceHash) const {
+    if (directory.empty()) {
+        return sourcePath + ".iecc";
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.iecc", (unsigned long long) sourceHash);
+
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// Returns the 64-bit FNV-1a hash of some bytes
+uint64_t ProgramCache::hash(std::string_view bytes) {
+    uint64_t value = 0xcbf29ce484222325ULL;
+
+    for (unsigned char byte : bytes) {
+        value = (value ^ byte) * 0x100000001b3ULL;
+    }
+
+    return value;
+}
+
+// Loads a cache file, any mismatch with the source or damage makes it unusable
+Node *ProgramCache::load(const std::string &sourcePath, std::string_view source, Arena &arena) const {
+    uint64_t sourceHash = hash(source);
+    std::string path = pathOf(sourcePath, sourceHash);
+
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return nullptr;
+    }
+
+    try {
+        SourceFile file(path);
+        std::string_view bytes = file.text();
+        Header header;
+
+        if (bytes.size() < sizeof(Header)) {
+            return nullptr;
+        }
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+
+        std::string_view payload = bytes.substr(sizeof(Header));
+        if (header.magic != MAGIC || header.version != VERSION || header.sourceHash != sourceHash || header.sourceSize != source.size()
+            || header.payloadSize != payload.size() || header.payloadHash != hash(payload)) {
+            return nullptr;
+        }
+
+        // Nothing is left in the arena if the payload turns out to be damaged
+        Arena nodes;
+        Node *program = Reader(payload, nodes).program();
+
+        // The bounds proofs are not cached but computed again on the loaded tree: a wrong proof would
+        // let an access write outside its array, so it must come from the tree that actually runs.
+        // The kernels of the vectorized loops are built again for the same reason.
+        RangeAnalysis rangeAnalysis;
+        Vectorizer vectorizer(nodes);
+        rangeAnalysis.analyze(program);
+        vectorizer.vectorize(program);
+
+        arena = std::move(nodes);
+
+        return program;
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+}
+
+// Writes the header and the payload to a temporary file that is then renamed, so a concurrent run
+// never maps a partially written file. The temporary name is unique to the thread and the moment,
+// two runs storing the same source (threads of a batch or other processes) never share it.
+void ProgramCache::store(const std::string &sourcePath, std::string_view source, const Node *program) const {
+    if (!program || program->kind != NodeKind::PROGRAM) {
+        return;
+    }
+
+    std::string payload;
+    Writer(payload).node(program);
+
+    uint64_t sourceHash = hash(source);
+    Header header{MAGIC, VERSION, sourceHash, source.size(), hash(payload), payload.size()};
+    std::string path = pathOf(sourcePath, sourceHash);
+    uint64_t stamp = std::hash<std::thread::id>()(std::this_thread::get_id())
+        ^ (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count();
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%016llx.tmp", (unsigned long long) stamp);
+    std::string temporary = path + suffix;
+    std::error_code error;
+
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, error);
+    }
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+        file.write(payload.data(), (std::streamsize) payload.size());
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,471 @@
+// File created by fob
+
+#include "../include/compiler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Throws a compile error with the provided error message specifying line and column
+void Compiler::throwError(const std::string &message, Node *node) {
+    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column);
+    throw std::runtime_error(errMsg);
+}
+
+// Checks if an integer expression can never raise a runtime error: literals, proven variables,
+// additions, subtractions, multiplications and negations of them
+static bool cannotFail(Node *node) {
+    node = unwrap(node);
+
+    switch (node->kind) {
+        case NodeKind::FACTOR:
+            return true;
+        case NodeKind::ID:
+            return !static_cast<IdNode *>(node)->checked;
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(node);
+            return cannotFail(addNode->left) && cannotFail(addNode->right);
+        }
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(node);
+            return mulNode->isMultiplication && cannotFail(mulNode->left) && cannotFail(mulNode->right);
+        }
+        case NodeKind::UNARY:
+            return cannotFail(static_cast<UnaryNode *>(node)->operand);
+        default:
+            return false;
+    }
+}
+
+// Checks if an assignment to a variable is x = x + k, x = k + x or x = x - k with x proven, storing
+// the step added to x (x - k wraps as x + -k)
+static bool isIncrement(IdNode *idNode, Node *exprNode, int &step) {
+    auto *addNode = node_cast<AddNode>(unwrap(exprNode));
+    if (idNode->checked || !addNode || addNode->valueType != ValueType::INT) {
+        return false;
+    }
+
+    IdNode *left = provenVariable(addNode->left);
+    IdNode *right = provenVariable(addNode->right);
+
+    if (left && left->slot == idNode->slot && literalValue(addNode->right, step)) {
+        step = addNode->isAddition ? step : (int) (0u - (uint32_t) step);
+        return true;
+    }
+
+    return addNode->isAddition && right && right->slot == idNode->slot && literalValue(addNode->left, step);
+}
+
+// Checks if an assignment to an array element is a[e] = a[e] + x or a[e] = x + a[e] with x an integer
+// expression that cannot fail, storing the element read and x. Evaluating x after the element
+// (or before it) then raises the same errors in the same order as the separate instructions.
+static bool isElementUpdate(ArrayAccessNode *locNode, Node *exprNode, ArrayAccessNode *&element, Node *&operand) {
+    auto *addNode = node_cast<AddNode>(unwrap(exprNode));
+    if (!addNode || !addNode->isAddition || addNode->valueType != ValueType::INT) {
+        return false;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        auto *read = node_cast<ArrayAccessNode>(unwrap(side == 0 ? addNode->left : addNode->right));
+        Node *other = side == 0 ? addNode->right : addNode->left;
+
+        if (read && read->slot == locNode->slot && sameExpr(read->index, locNode->index) && cannotFail(other)) {
+            element = read;
+            operand = other;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Appends an instruction and returns its position
+int Compiler::emit(OpCode op, Node *node, int a, int b, int c) {
+    chunk.code.push_back({op, a, b, c});
+    chunk.nodes.push_back(node);
+
+    return (int) chunk.code.size() - 1;
+}
+
+// Sets the target of the jump instruction at the given position
+void Compiler::patchJump(int position, int target) {
+    Instruction &instruction = chunk.code[position];
+
+    if (instruction.op == OpCode::JUMP) {
+        instruction.a = target;
+    } else if (instruction.op == OpCode::JUMP_IF_FALSE || instruction.op == OpCode::JUMP_IF_TRUE) {
+        instruction.b = target;
+    } else {
+        instruction.c = target;
+    }
+}
+
+// Compiles the root program node
+Chunk Compiler::compile(Node *node) {
+    chunk = Chunk();
+    breakJumps.clear();
+
+    if (auto *programNode = node_cast<ProgramNode>(node)) {
+        chunk.variables = programNode->variables;
+        compileBlock(programNode->block);
+        emit(OpCode::HALT, programNode);
+    } else {
+        throwError("Program should start with a ProgramNode", node);
+    }
+
+    return std::move(chunk);
+}
+
+// Compiles a block node
+void Compiler::compileBlock(Node *blockNode) {
+    if (auto *block = node_cast<BlockNode>(blockNode)) {
+        if (Node *decls = block->decls) {
+            compileDecls(decls);
+        }
+
+        if (Node *stmts = block->stmts) {
+            compileStmts(stmts);
+        }
+    } else {
+        throwError("Invalid block node", blockNode);
+    }
+}
+
+// Compiles a sequence of declarations
+void Compiler::compileDecls(Node *declsNode) {
+    auto *decls = node_cast<DeclsNode>(declsNode);
+    if (!decls) {
+        throwError("Invalid declarations node", declsNode);
+    }
+
+    for (Node *decl : *decls) {
+        compileDecl(decl);
+    }
+}
+
+// Compiles a single declaration
+void Compiler::compileDecl(Node *declNode) {
+    auto *decl = node_cast<DeclNode>(declNode);
+    if (!decl) {
+        throwError("Invalid declaration node", declNode);
+    }
+
+    int size = -1;
+    Node *typeNode = decl->type;
+
+    // Array Types
+    if (auto *arrayType = node_cast<ArrayTypeNode>(typeNode)) {
+        size = arrayType->arraySize;
+        typeNode = arrayType->type;
+    }
+
+    // Basic types
+    if (auto *basicType = node_cast<BasicTypeNode>(typeNode)) {
+        if (basicType->typeName == "integer") {
+            emit(OpCode::DECLARE, decl, decl->slot, 0, size);
+        } else if (basicType->typeName == "boolean") {
+            emit(OpCode::DECLARE, decl, decl->slot, 1, size);
+        } else {
+            throwError("Unknown basic type " + std::string(basicType->typeName), basicType);
+        }
+    } else {
+        throwError("Invalid type node in declaration", decl);
+    }
+}
+
+// Compiles a sequence of statements
+void Compiler::compileStmts(Node *stmtsNode) {
+    auto *stmts = node_cast<StmtsNode>(stmtsNode);
+    if (!stmts) {
+        throwError("Invalid statements node", stmtsNode);
+    }
+
+    for (Node *stmt : *stmts) {
+        compileStmt(stmt);
+    }
+}
+
+// Compiles a single statement
+void Compiler::compileStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        // Assign
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            compileAssign(assign->loc, assign->expr);
+            break;
+        }
+        // If
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            int skip = compileBranch(ifStmt->condition, false, ifStmt);
+            compileStmt(ifStmt->ifStmt);
+            patchJump(skip, (int) chunk.code.size());
+            break;
+        }
+        // If Else
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            int toElse = compileBranch(ifElseStmt->condition, false, ifElseStmt);
+            compileStmt(ifElseStmt->ifStmt);
+            int toEnd = emit(OpCode::JUMP, ifElseStmt);
+            patchJump(toElse, (int) chunk.code.size());
+            compileStmt(ifElseStmt->elseStmt);
+            patchJump(toEnd, (int) chunk.code.size());
+            break;
+        }
+        // While: the condition is placed after the body so that each iteration costs a single jump
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            if (whileStmt->vector) {
+                emit(OpCode::VECTOR_LOOP, whileStmt);
+            }
+
+            int toCondition = emit(OpCode::JUMP, whileStmt);
+            int body = (int) chunk.code.size();
+
+            breakJumps.emplace_back();
+            compileStmt(whileStmt->body);
+            patchJump(toCondition, (int) chunk.code.size());
+            compileBranch(whileStmt->condition, true, whileStmt, body);
+
+            for (int jump : breakJumps.back()) {
+                patchJump(jump, (int) chunk.code.size());
+            }
+            breakJumps.pop_back();
+            break;
+        }
+        // Do While
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            int body = (int) chunk.code.size();
+
+            breakJumps.emplace_back();
+            compileStmt(doWhileStmt->body);
+            compileBranch(doWhileStmt->condition, true, doWhileStmt, body);
+
+            for (int jump : breakJumps.back()) {
+                patchJump(jump, (int) chunk.code.size());
+            }
+            breakJumps.pop_back();
+            break;
+        }
+        // Print
+        case NodeKind::PRINT: {
+            auto *printStmt = static_cast<PrintNode *>(stmtNode);
+            compileExpr(printStmt->expr, 0);
+            emit(OpCode::PRINT, printStmt, 0, printStmt->expr->valueType == ValueType::INT ? 0 : 1);
+            break;
+        }
+        // Break
+        case NodeKind::BREAK:
+            if (breakJumps.empty()) {
+                emit(OpCode::BREAK, stmtNode);
+            } else {
+                breakJumps.back().push_back(emit(OpCode::JUMP, stmtNode));
+            }
+            break;
+        // Block
+        case NodeKind::BLOCK:
+            compileBlock(stmtNode);
+            break;
+        default:
+            throwError("Unknown statement type", stmtNode);
+    }
+}
+
+// Compiles an assignment to a variable or array element, increments and element updates are fused
+void Compiler::compileAssign(Node *locNode, Node *exprNode) {
+    int step;
+    ArrayAccessNode *element;
+    Node *operand;
+
+    if (auto *idNode = node_cast<IdNode>(locNode)) {
+        if (isIncrement(idNode, exprNode, step)) {
+            emit(OpCode::INC_VAR, idNode, idNode->slot, step);
+            return;
+        }
+
+        // The variable is checked before the value, whose errors come after an undeclared variable
+        if (idNode->checked && !cannotFail(exprNode)) {
+            emit(OpCode::CHECK_DECLARED, idNode, idNode->slot);
+        }
+        compileExpr(exprNode, 0);
+        emit(idNode->checked ? OpCode::STORE_VAR : OpCode::STORE_VAR_FAST, idNode, idNode->slot, 0);
+    } else if (auto *arrayAccessNode = node_cast<ArrayAccessNode>(locNode)) {
+        bool update = isElementUpdate(arrayAccessNode, exprNode, element, operand);
+
+        // The array is checked before the index and the value, whose errors come after an undeclared array
+        if (!cannotFail(arrayAccessNode->index) || (!update && !cannotFail(exprNode))) {
+            emit(OpCode::CHECK_DECLARED, arrayAccessNode, arrayAccessNode->slot);
+        }
+        compileExpr(arrayAccessNode->index, 0);
+
+        // The errors of the update are those of the element read, so they report its node
+        if (update) {
+            compileExpr(operand, 1);
+            emit(element->checkBounds ? OpCode::ADD_ELEM : OpCode::ADD_ELEM_FAST, element, arrayAccessNode->slot, 0, 1);
+            return;
+        }
+
+        compileExpr(exprNode, 1);
+        emit(arrayAccessNode->checkBounds ? OpCode::STORE_ELEM : OpCode::STORE_ELEM_FAST, arrayAccessNode, arrayAccessNode->slot, 0, 1);
+    } else {
+        throwError("Invalid location node in assignment", locNode);
+    }
+}
+
+// Compiles a binary operation: left goes into dst, right into dst + 1
+void Compiler::compileBinary(OpCode op, Node *node, Node *left, Node *right, int dst) {
+    compileExpr(left, dst);
+    compileExpr(right, dst + 1);
+    emit(op, node, dst, dst, dst + 1);
+}
+
+// Compiles a conditional jump. A comparison of a proven variable with another one or with a literal
+// becomes a single fused compare and branch, any other condition is evaluated in r0 and tested.
+int Compiler::compileBranch(Node *condition, bool when, Node *node, int target) {
+    static const OpCode variableOps[] = { OpCode::JUMP_IF_LESS, OpCode::JUMP_IF_LESSEQ, OpCode::JUMP_IF_GREATER,
+                                          OpCode::JUMP_IF_GREATEREQ, OpCode::JUMP_IF_EQ, OpCode::JUMP_IF_NEQ };
+    static const OpCode literalOps[] = { OpCode::JUMP_IF_LESS_INT, OpCode::JUMP_IF_LESSEQ_INT, OpCode::JUMP_IF_GREATER_INT,
+                                         OpCode::JUMP_IF_GREATEREQ_INT, OpCode::JUMP_IF_EQ_INT, OpCode::JUMP_IF_NEQ_INT };
+    static const int negated[] = { 3, 2, 1, 0, 5, 4 };     // !(a < b) is a >= b, !(a <= b) is a > b, ...
+    static const int mirrored[] = { 2, 3, 0, 1, 4, 5 };    // k < a is a > k, k <= a is a >= k, ...
+
+    int comparison = -1;    // Index in the tables: <, <=, >, >=, ==, !=
+    Node *left = nullptr;
+    Node *right = nullptr;
+    int value;
+
+    if (auto *relNode = node_cast<RelNode>(unwrap(condition))) {
+        comparison = relNode->op;
+        left = relNode->left;
+        right = relNode->right;
+    } else if (auto *eqNode = node_cast<EqualityNode>(unwrap(condition))) {
+        comparison = eqNode->isEqual ? 4 : 5;
+        left = eqNode->left;
+        right = eqNode->right;
+    }
+
+    if (comparison >= 0) {
+        comparison = when ? comparison : negated[comparison];
+
+        if (literalValue(left, value) && provenVariable(right)) {
+            std::swap(left, right);
+            comparison = mirrored[comparison];
+        }
+
+        if (IdNode *variable = provenVariable(left)) {
+            if (IdNode *other = provenVariable(right)) {
+                return emit(variableOps[comparison], node, variable->slot, other->slot, target);
+            }
+
+            if (literalValue(right, value)) {
+                return emit(literalOps[comparison], node, variable->slot, value, target);
+            }
+        }
+    }
+
+    compileExpr(condition, 0);
+    return emit(when ? OpCode::JUMP_IF_TRUE : OpCode::JUMP_IF_FALSE, node, 0, target);
+}
+
+// Compiles an expression
+void Compiler::compileExpr(Node *exprNode, int dst) {
+    chunk.registerCount = std::max(chunk.registerCount, dst + 1);
+
+    switch (exprNode->kind) {
+        // Multiplication
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            OpCode op = mulNode->valueType == ValueType::INT ? (mulNode->isMultiplication ? OpCode::MUL : OpCode::DIV)
+                                                             : (mulNode->isMultiplication ? OpCode::MUL_BOOL : OpCode::DIV_BOOL);
+            compileBinary(op, mulNode, mulNode->left, mulNode->right, dst);
+            break;
+        }
+        // Addition
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            OpCode op = addNode->valueType == ValueType::INT ? (addNode->isAddition ? OpCode::ADD : OpCode::SUB)
+                                                             : (addNode->isAddition ? OpCode::ADD_BOOL : OpCode::SUB_BOOL);
+            compileBinary(op, addNode, addNode->left, addNode->right, dst);
+            break;
+        }
+        // Unary operation
+        case NodeKind::UNARY: {
+            auto *unaryNode = static_cast<UnaryNode *>(exprNode);
+            compileExpr(unaryNode->operand, dst);
+            emit(unaryNode->op == UnaryNode::NOT ? OpCode::NOT : OpCode::NEG, unaryNode, dst, dst);
+            break;
+        }
+        // Factor
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            switch (factorNode->type) {
+                case FactorNode::BOOL: emit(OpCode::LOAD_BOOL, factorNode, dst, factorNode->boolValue); break;
+                case FactorNode::INT: emit(OpCode::LOAD_INT, factorNode, dst, factorNode->intValue); break;
+                case FactorNode::ID: compileExpr(factorNode->loc, dst); break;
+            }
+            break;
+        }
+        // Or: the right operand is skipped when the left one is true
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            compileExpr(orNode->left, dst);
+            if (orNode->left->valueType == ValueType::INT) {
+                emit(OpCode::TO_BOOL, orNode, dst, dst);
+            }
+            int toEnd = emit(OpCode::JUMP_IF_TRUE, orNode, dst);
+            compileExpr(orNode->right, dst);
+            if (orNode->right->valueType == ValueType::INT) {
+                emit(OpCode::TO_BOOL, orNode, dst, dst);
+            }
+            patchJump(toEnd, (int) chunk.code.size());
+            break;
+        }
+        // And: the right operand is skipped when the left one is false
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            compileExpr(andNode->left, dst);
+            if (andNode->left->valueType == ValueType::INT) {
+                emit(OpCode::TO_BOOL, andNode, dst, dst);
+            }
+            int toEnd = emit(OpCode::JUMP_IF_FALSE, andNode, dst);
+            compileExpr(andNode->right, dst);
+            if (andNode->right->valueType == ValueType::INT) {
+                emit(OpCode::TO_BOOL, andNode, dst, dst);
+            }
+            patchJump(toEnd, (int) chunk.code.size());
+            break;
+        }
+        // Equality
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            compileBinary(eqNode->isEqual ? OpCode::EQ : OpCode::NEQ, eqNode, eqNode->left, eqNode->right, dst);
+            break;
+        }
+        // Relation
+        case NodeKind::REL: {
+            static const OpCode relOps[] = { OpCode::LESS, OpCode::LESSEQ, OpCode::GREATER, OpCode::GREATEREQ };
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            compileBinary(relOps[relNode->op], relNode, relNode->left, relNode->right, dst);
+            break;
+        }
+        // Id
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+            emit(idNode->checked ? OpCode::LOAD_VAR : OpCode::LOAD_VAR_FAST, idNode, dst, idNode->slot);
+            break;
+        }
+        // Array access
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            if (!cannotFail(arrayAccessNode->index)) {
+                emit(OpCode::CHECK_DECLARED, arrayAccessNode, arrayAccessNode->slot);
+            }
+            compileExpr(arrayAccessNode->index, dst);
+            emit(arrayAccessNode->checkBounds ? OpCode::LOAD_ELEM : OpCode::LOAD_ELEM_FAST, arrayAccessNode, dst, arrayAccessNode->slot, dst);
+            break;
+        }
+        default:
+            throwError("Node compilation not implemented yet", exprNode);
+    }
+}
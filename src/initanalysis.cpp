@@ -0,0 +1,282 @@
+// File created by fob
+
+#include "../include/initanalysis.h"
+
+// Analyzes the root program node
+void InitAnalysis::analyze(Node *node) {
+    auto *program = node_cast<ProgramNode>(node);
+    if (!program) {
+        return;
+    }
+
+    size_t slots = program->variables.size();
+    state = State();
+    state.declared.assign(slots, false);
+    state.initialized.assign(slots, false);
+    breakStates.clear();
+    checkedReads.assign(slots, false);
+    writes.clear();
+
+    analyzeBlock(program->block);
+
+    // An assignment needs its checks when the variable may be undeclared, or when some read
+    // of the variable still checks the initialized flag that the assignment has to set
+    for (IdNode *write : writes) {
+        write->checked = write->checked || checkedReads[write->slot];
+    }
+}
+
+// Keeps only the facts holding on both paths, code that is not reachable adds no constraint
+void InitAnalysis::merge(State &into, const State &from) {
+    if (!from.reachable) {
+        return;
+    }
+    if (!into.reachable) {
+        into = from;
+        return;
+    }
+
+    for (size_t slot = 0; slot < into.declared.size(); slot++) {
+        into.declared[slot] = into.declared[slot] && from.declared[slot];
+        into.initialized[slot] = into.initialized[slot] && from.initialized[slot];
+    }
+}
+
+// Records the slots declared inside a statement
+void InitAnalysis::collectKills(Node *node, std::vector<bool> &kills) {
+    switch (node->kind) {
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(node);
+            if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+                for (Node *decl : *decls) {
+                    kills[static_cast<DeclNode *>(decl)->slot] = true;
+                }
+            }
+            if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+                for (Node *stmt : *stmts) {
+                    collectKills(stmt, kills);
+                }
+            }
+            break;
+        }
+        case NodeKind::IF:
+            collectKills(static_cast<IfNode *>(node)->ifStmt, kills);
+            break;
+        case NodeKind::IF_ELSE:
+            collectKills(static_cast<IfElseNode *>(node)->ifStmt, kills);
+            collectKills(static_cast<IfElseNode *>(node)->elseStmt, kills);
+            break;
+        case NodeKind::WHILE:
+            collectKills(static_cast<WhileNode *>(node)->body, kills);
+            break;
+        case NodeKind::DO_WHILE:
+            collectKills(static_cast<DoWhileNode *>(node)->body, kills);
+            break;
+        default:
+            break;
+    }
+}
+
+// Analyzes a block: each declaration (re)declares its variable and leaves it uninitialized
+void InitAnalysis::analyzeBlock(Node *blockNode) {
+    auto *block = node_cast<BlockNode>(blockNode);
+    if (!block) {
+        return;
+    }
+
+    if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+        for (Node *decl : *decls) {
+            int slot = static_cast<DeclNode *>(decl)->slot;
+            state.declared[slot] = true;
+            state.initialized[slot] = false;
+        }
+    }
+
+    if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+        for (Node *stmt : *stmts) {
+            analyzeStmt(stmt);
+        }
+    }
+}
+
+// Moves the state to the head of a loop.
+// The head is reached from the loop entry and from the end of the body: the body can only
+// add facts, except for the variables it declares, so the entry facts minus those declared
+// in the body hold at every iteration without iterating the analysis to a fixed point.
+void InitAnalysis::analyzeLoopHead(Node *body) {
+    std::vector<bool> kills(state.initialized.size(), false);
+    collectKills(body, kills);
+
+    for (size_t slot = 0; slot < kills.size(); slot++) {
+        if (kills[slot]) {
+            state.initialized[slot] = false;
+        }
+    }
+}
+
+// Analyzes a single statement
+void InitAnalysis::analyzeStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        // Assign: once it is done the variable is declared (and initialized for scalars)
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+
+            if (auto *idNode = node_cast<IdNode>(assign->loc)) {
+                analyzeExpr(assign->expr);
+
+                idNode->checked = state.reachable && !state.declared[idNode->slot];
+                writes.push_back(idNode);
+
+                state.declared[idNode->slot] = true;
+                state.initialized[idNode->slot] = true;
+            } else if (auto *arrayAccessNode = node_cast<ArrayAccessNode>(assign->loc)) {
+                analyzeExpr(arrayAccessNode->index);
+                analyzeExpr(assign->expr);
+
+                state.declared[arrayAccessNode->slot] = true;
+            }
+            break;
+        }
+        // If: the facts after the statement are those holding on both branches
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            analyzeExpr(ifStmt->condition);
+
+            State skipped = state;
+            analyzeStmt(ifStmt->ifStmt);
+            merge(state, skipped);
+            break;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            analyzeExpr(ifElseStmt->condition);
+
+            State elseState = state;
+            analyzeStmt(ifElseStmt->ifStmt);
+            std::swap(state, elseState);
+            analyzeStmt(ifElseStmt->elseStmt);
+            merge(state, elseState);
+            break;
+        }
+        // While: the loop is left when the condition is false at the head or through a break
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            analyzeLoopHead(whileStmt->body);
+            analyzeExpr(whileStmt->condition);
+
+            State exit = state;
+            breakStates.push_back(State{{}, {}, false});
+            analyzeStmt(whileStmt->body);
+
+            merge(exit, breakStates.back());
+            breakStates.pop_back();
+            state = exit;
+            break;
+        }
+        // Do While: the loop is left when the condition is false after the body or through a break
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            analyzeLoopHead(doWhileStmt->body);
+
+            breakStates.push_back(State{{}, {}, false});
+            analyzeStmt(doWhileStmt->body);
+            analyzeExpr(doWhileStmt->condition);
+
+            merge(state, breakStates.back());
+            breakStates.pop_back();
+            break;
+        }
+        case NodeKind::PRINT:
+            analyzeExpr(static_cast<PrintNode *>(stmtNode)->expr);
+            break;
+        // Break: the facts flow to the end of the enclosing loop, the next statements are unreachable
+        case NodeKind::BREAK:
+            if (!breakStates.empty()) {
+                merge(breakStates.back(), state);
+            }
+            state.reachable = false;
+            break;
+        case NodeKind::BLOCK:
+            analyzeBlock(stmtNode);
+            break;
+        default:
+            break;
+    }
+}
+
+// Analyzes the reads of an expression
+void InitAnalysis::analyzeExpr(Node *exprNode) {
+    switch (exprNode->kind) {
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            analyzeExpr(mulNode->left);
+            analyzeExpr(mulNode->right);
+            break;
+        }
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            analyzeExpr(addNode->left);
+            analyzeExpr(addNode->right);
+            break;
+        }
+        case NodeKind::UNARY:
+            analyzeExpr(static_cast<UnaryNode *>(exprNode)->operand);
+            break;
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            if (factorNode->type == FactorNode::ID) {
+                analyzeExpr(factorNode->loc);
+            }
+            break;
+        }
+        // Short circuit: the right operand may be skipped, so its reads prove nothing afterwards
+        case NodeKind::OR:
+        case NodeKind::AND: {
+            Node *left = exprNode->kind == NodeKind::OR ? static_cast<OrNode *>(exprNode)->left : static_cast<AndNode *>(exprNode)->left;
+            Node *right = exprNode->kind == NodeKind::OR ? static_cast<OrNode *>(exprNode)->right : static_cast<AndNode *>(exprNode)->right;
+
+            analyzeExpr(left);
+            State skipped = state;
+            analyzeExpr(right);
+            state = skipped;
+            break;
+        }
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            analyzeExpr(eqNode->left);
+            analyzeExpr(eqNode->right);
+            break;
+        }
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            analyzeExpr(relNode->left);
+            analyzeExpr(relNode->right);
+            break;
+        }
+        case NodeKind::ID:
+            analyzeRead(static_cast<IdNode *>(exprNode));
+            break;
+        // Array access: a read that does not fail proves that the array is declared
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            analyzeExpr(arrayAccessNode->index);
+            state.declared[arrayAccessNode->slot] = true;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Analyzes the read of a scalar variable: the checks are dropped when it is definitely initialized.
+// A read that does not fail proves that the variable is declared and initialized afterwards.
+void InitAnalysis::analyzeRead(IdNode *node) {
+    node->checked = state.reachable && !state.initialized[node->slot];
+
+    if (node->checked) {
+        checkedReads[node->slot] = true;
+    }
+
+    state.declared[node->slot] = true;
+    state.initialized[node->slot] = true;
+}
@@ -0,0 +1,27 @@
+// File created by fob
+
+#include "../include/interner.h"
+
+// Returns the symbol of a name, adding the name to the table the first time it is seen
+int Interner::intern(std::string_view name) {
+    auto symbol = symbols.find(name);
+    if (symbol != symbols.end()) {
+        return symbol->second;
+    }
+
+    int index = (int) names.size();
+    names.emplace_back(name);
+    symbols.insert({std::string_view(names.back()), index});
+
+    return index;
+}
+
+// Returns the name of a symbol
+std::string_view Interner::name(int symbol) const {
+    return names[symbol];
+}
+
+// Returns the number of distinct names in the table
+int Interner::size() const {
+    return (int) names.size();
+}
@@ -1,355 +1,437 @@
-// File created by fob
-
-#include "../include/interpreter.h"
-
-// Returns the size of the array if it is an array
-int Variable::size() const {
-    if (!isArray) {
-        throw std::runtime_error("Error: Variable is not an array");
-    } else {
-        return (int) std::max(intArray.size(), boolArray.size());         // Returns the size of either the intArray or boolArray
-    }
-}
-
-// Checks if a variable with the specified name is declared in the map
-bool SymbolMap::isDeclared(const std::string &name) const {
-    return map.find(name) != map.end();
-}
-
-// Declares a new variable with the specified name, type, and array properties if it is an array
-void SymbolMap::declareVariable(const std::string &name, Type type, bool isArray, int arraySize) {
-    if (isDeclared(name)) {
-        map.erase(name); // Removes the old variable if it exists
-    }
-
-    Variable variable;
-
-    variable.type = type;
-    variable.isArray = isArray;
-
-    if (isArray) {
-        // Initializes arrays based on the variable type
-        if (type == Type::INT) {
-            variable.intArray.resize(arraySize, 0);
-        } else {
-            variable.boolArray.resize(arraySize, false);
-        }
-        variable.arrayInitialized.resize(arraySize, false); // Tracking for variable in array initialized
-    }
-
-    map.insert({name, variable});
-}
-
-// Retrieves a variable by name
-Variable &SymbolMap::getVariable(const std::string &name) {
-    if (!isDeclared(name)) {
-        std::string errMsg = "Error: Variable " + name + " not initialized";
-        throw std::runtime_error(errMsg);
-    }
-
-    return map[name];
-}
-
-// Throws a runtime error with the provided error message specifying line and colum
-void Interpreter::throwError(const std::string &message, Node *node) {
-    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column) + " type " + typeid(node).name();
-    throw std::runtime_error(errMsg);
-}
-
-// Assigns a value to a variable or array element
-void Interpreter::assignValue(Node *locNode, Node *exprNode) {
-    if (auto *idNode = dynamic_cast<IdNode *>(locNode)) {
-        Variable &variable = symbolMap.getVariable(idNode->id);
-        Result value = evaluateExpr(exprNode);
-
-        // Checks if types match between the variable and the expression result
-        if (variable.type == value.type) {
-            if (variable.type == Type::INT && !variable.isArray) {
-                variable.intValue = value.value;
-            } else if (variable.type == Type::BOOL && !variable.isArray) {
-                variable.boolValue = (bool) value.value;
-            } else {
-                throwError("Invalid assignment", idNode);
-            }
-        } else {
-            throwError("Value mismatch", idNode);
-        }
-
-        variable.initialized = true;
-    } else if (auto *arrayAccessNode = dynamic_cast<ArrayAccessNode *>(locNode)) {
-        Variable &variable = symbolMap.getVariable(arrayAccessNode->id);
-        Result index = evaluateExpr(arrayAccessNode->index);
-        Result value = evaluateExpr(exprNode);
-
-        // Check the array index bounds
-        int idx = index.type == Type::INT ? index.value : (bool) index.value;
-        if (idx < 0 || idx >= variable.size()) {
-            throwError("Array index out of bounds 0<=" + std::to_string(idx) + "<" + std::to_string(variable.size()) , arrayAccessNode);
-        } else {
-            // Ensures the value type matches
-            if (variable.type == value.type) {
-                if (variable.type == Type::INT && variable.isArray) {
-                    variable.intArray[idx] = value.value;
-                } else if (variable.type == Type::BOOL && variable.isArray) {
-                    variable.boolArray[idx] = (bool) value.value;
-                } else {
-                    throwError("Invalid array assignment", arrayAccessNode);
-                }
-            } else {
-                throwError("Value mismatch", arrayAccessNode);
-            }
-        }
-
-        variable.arrayInitialized.insert(variable.arrayInitialized.begin() + index.value, true);
-    } else {
-        throwError("Invalid location node in assignment", locNode);
-    }
-}
-
-// Interpret the root program node
-void Interpreter::interpret(Node* node) {
-    if (auto *programNode = dynamic_cast<ProgramNode *>(node)) {
-        executeBlock(programNode->block);
-    } else {
-        throwError("Program should start with a ProgramNode", programNode);
-    }
-}
-
-// Executes a block node
-void Interpreter::executeBlock(Node *blockNode) {
-    if (auto *block = dynamic_cast<BlockNode *>(blockNode)) {
-        if (Node *decls = block->decls) {
-            executeDecls(decls);
-        }
-
-        if (Node *stmts = block->stmts) {
-            executeStmts(stmts);
-        }
-    } else {
-        throwError("Invalid block node", blockNode);
-    }
-}
-
-// Executes a sequence of declarations
-void Interpreter::executeDecls(Node *declsNode) {
-    if (auto *decls = dynamic_cast<DeclsNode *>(declsNode)) {
-        executeDecl(decls->decl); // Run the current declaration
-
-        if (Node *next = decls->next) {
-            executeDecls(next);
-        }
-    } else {
-        throwError("Invalid declarations node", declsNode);
-    }
-}
-
-// Executes a single declaration
-void Interpreter::executeDecl(Node *declNode) {
-    if (auto *decl = dynamic_cast<DeclNode *>(declNode)) {
-        // Basic types
-        if (auto *basicType = dynamic_cast<BasicTypeNode *>(decl->type)) {
-            if (basicType->typeName == "integer") {
-                symbolMap.declareVariable(decl->id, Type::INT);
-            } else if (basicType->typeName == "boolean") {
-                symbolMap.declareVariable(decl->id, Type::BOOL);
-            } else {
-                throwError("Unknown basic type " + basicType->typeName, basicType);
-            }
-        // Array Types
-        } else if (auto *arrayType = dynamic_cast<ArrayTypeNode *>(decl->type)) {
-            if (auto *baseType = dynamic_cast<BasicTypeNode *>(arrayType->type)) {
-                if (baseType->typeName == "integer") {
-                    symbolMap.declareVariable(decl->id, Type::INT, true, arrayType->arraySize);
-                } else if (baseType->typeName == "boolean") {
-                    symbolMap.declareVariable(decl->id, Type::BOOL, true, arrayType->arraySize);
-                } else {
-                    throwError("Unknown array base type " + baseType->typeName, baseType);
-                }
-            } else {
-                throwError("Invalid array type", arrayType);
-            }
-        } else {
-            throwError("Invalid type node in declaration", decl);
-        }
-    } else {
-        throwError("Invalid declaration node", declNode);
-    }
-}
-
-// Executes a sequence of statements
-void Interpreter::executeStmts(Node *stmtsNode) {
-    if (auto *stmts = dynamic_cast<StmtsNode *>(stmtsNode)) {
-        executeStmt(stmts->stmt); // Run the current statement
-
-        if (Node *next = stmts->next) {
-            executeStmts(next);
-        }
-    } else {
-        throwError("Invalid statements node", stmtsNode);
-    }
-}
-
-// Executes a single statement
-void Interpreter::executeStmt(Node *stmtNode) {
-    // Assign
-    if (auto *assign = dynamic_cast<AssignNode *>(stmtNode)) {
-        assignValue(assign->loc, assign->expr);
-    // If
-    } else if (auto *ifStmt = dynamic_cast<IfNode *>(stmtNode)) {
-        if ((bool) evaluateExpr(ifStmt->condition).value) {
-            executeStmt(ifStmt->ifStmt);
-        }
-    // If Else
-    } else if (auto *ifElseStmt = dynamic_cast<IfElseNode *>(stmtNode)) {
-        if ((bool) evaluateExpr(ifElseStmt->condition).value) {
-            executeStmt(ifElseStmt->ifStmt);
-        } else {
-            executeStmt(ifElseStmt->elseStmt);
-        }
-    // While
-    } else if (auto *whileStmt = dynamic_cast<WhileNode *>(stmtNode)) {
-        try {
-            while ((bool) evaluateExpr(whileStmt->condition).value) {
-                executeStmt(whileStmt->body);
-            }
-        } catch (const BreakException &) {
-            // Exit from the cycle
-        }
-    // Do While
-    } else if (auto *doWhileStmt = dynamic_cast<DoWhileNode *>(stmtNode)) {
-        try {
-            do {
-                executeStmt(doWhileStmt->body);
-            } while ((bool) evaluateExpr(doWhileStmt->condition).value);
-        } catch (const BreakException &) {
-            // Exit from the cycle
-        }
-    // Print
-    } else if (auto *printStmt = dynamic_cast<PrintNode *>(stmtNode)) {
-        Result result = evaluateExpr(printStmt->expr);
-
-        if (result.type == Type::INT) {
-            std::cout << result.value << std::endl;
-        } else if (result.type == Type::BOOL) {
-            std::cout << ((bool) result.value ? "true" : "false") << std::endl;
-        }
-    // Break
-    } else if (auto *_ = dynamic_cast<BreakNode *>(stmtNode)) {
-        throw BreakException();
-    } else if (auto *blockStmt = dynamic_cast<BlockNode *>(stmtNode)) {
-        executeBlock(blockStmt);
-    } else {
-        throwError("Unknown statement type", stmtNode);
-    }
-}
-
-// Evaluates an expression
-Result Interpreter::evaluateExpr(Node *exprNode) {
-    // Multiplication
-    if (auto *mulNode = dynamic_cast<MulNode *>(exprNode)) {
-        Result leftValue = evaluateExpr(mulNode->left);
-        Result rightValue = evaluateExpr(mulNode->right);
-
-        if (!mulNode->isMultiplication && (rightValue.type == Type::INT && rightValue.value == 0 || rightValue.type == Type::BOOL && !rightValue.value)) {
-            throwError("Impossible dividing by 0", mulNode);
-        }
-
-        if (leftValue.type != rightValue.type) {
-            throwError("Value type mismatch", mulNode);
-        }
-
-        if (leftValue.type == Type::INT) {
-            return Result(mulNode->isMultiplication ? leftValue.value * rightValue.value : leftValue.value / rightValue.value);
-        } else {
-            return Result(mulNode->isMultiplication ? (bool) ((bool) leftValue.value * (bool) rightValue.value) : (bool) leftValue.value);
-        }
-    // Addition
-    } else if (auto *addNode = dynamic_cast<AddNode *>(exprNode)) {
-        Result leftValue = evaluateExpr(addNode->left);
-        Result rightValue = evaluateExpr(addNode->right);
-
-        if (leftValue.type != rightValue.type) {
-            throwError("Value type mismatch", addNode);
-        }
-
-        if (leftValue.type == Type::INT) {
-            return Result(addNode->isAddition ? leftValue.value + rightValue.value : leftValue.value - rightValue.value);
-        } else {
-            return Result(addNode->isAddition ? (bool) ((bool) leftValue.value + (bool) rightValue.value) : (bool) ((bool) leftValue.value - (bool) rightValue.value));
-        }
-    // Unary operation
-    } else if (auto *unaryNode = dynamic_cast<UnaryNode *>(exprNode)) {
-        Result operand = evaluateExpr(unaryNode->operand);
-
-        // Not
-        if (unaryNode->op == UnaryNode::Op::NOT && operand.type == Type::BOOL) {
-            return Result(!(bool) operand.value);
-        // Minus
-        } else if (unaryNode->op == UnaryNode::Op::NEG && operand.type == Type::INT) {
-            return Result(-operand.value);
-        } else {
-            throwError("Mismatched unary operation type", unaryNode);
-        }
-    // Factor
-    } else if (auto *factorNode = dynamic_cast<FactorNode *>(exprNode)) {
-        switch (factorNode->type) {
-            case FactorNode::BOOL: return Result(factorNode->boolValue);
-            case FactorNode::INT: return Result(factorNode->intValue);
-            case FactorNode::ID: return evaluateExpr(factorNode->loc);
-        }
-    // Or
-    } else if (auto *orNode = dynamic_cast<OrNode *>(exprNode)) {
-        return Result((bool) evaluateExpr(orNode->left).value || (bool) evaluateExpr(orNode->right).value);
-    // And
-    } else if (auto *andNode = dynamic_cast<AndNode *>(exprNode)) {
-        return Result((bool) evaluateExpr(andNode->left).value && (bool) evaluateExpr(andNode->right).value);
-    // Equality
-    } else if (auto *eqNode = dynamic_cast<EqualityNode *>(exprNode)) {
-        Result leftValue = evaluateExpr(eqNode->left);
-        Result rightValue = evaluateExpr(eqNode->right);
-
-        if (leftValue.type != rightValue.type) {
-            throwError("Value type mismatch", addNode);
-        }
-
-        if (leftValue.type == Type::INT) {
-            return Result(eqNode->isEqual == (leftValue.value == rightValue.value));
-        } else {
-            return Result(eqNode->isEqual == ((bool) leftValue.value == (bool) rightValue.value));
-        }
-    // Relation
-    } else if (auto *relNode = dynamic_cast<RelNode *>(exprNode)) {
-        Result left = evaluateExpr(relNode->left);
-        Result right = evaluateExpr(relNode->right);
-
-        switch (relNode->op) {
-            case RelNode::LESS: return Result(left.value < right.value);
-            case RelNode::LESSEQ: return Result(left.value <= right.value);
-            case RelNode::GREATER: return Result(left.value > right.value);
-            case RelNode::GREATEREQ: return Result(left.value >= right.value);
-        }
-    // Id
-    } else if (auto *idNode = dynamic_cast<IdNode *>(exprNode)) {
-        Variable &variable = symbolMap.getVariable(idNode->id);
-
-        if (!variable.initialized) {
-            throwError("Variable" + idNode->id + " not initialized yet", idNode);
-        }
-
-        return variable.type == Type::INT ? Result(variable.intValue) : Result(variable.boolValue);
-    // Array access
-    } else if (auto *arrayAccessNode = dynamic_cast<ArrayAccessNode *>(exprNode)) {
-        Variable &variable = symbolMap.getVariable(arrayAccessNode->id);
-        int index = evaluateExpr(arrayAccessNode->index).value;
-
-        if (!variable.arrayInitialized[index]) {
-            throwError("Array " + arrayAccessNode->id + " value at " + std::to_string(index) + " not initialized yet", arrayAccessNode);
-        }
-
-        return variable.type == Type::INT ? Result(variable.intArray[index]) : Result(variable.boolArray[index]);
-    } else {
-        throwError("Node interpretation not implemented yet", exprNode);
-    }
-
-    return Result(0); // Default value ( Should never be called )
-}
\ No newline at end of file
+// File created by fob
+
+#include "../include/interpreter.h"
+#include "../include/vectorloop.h"
+
+#include <algorithm>
+
+// Prepares an undeclared slot for each variable name of the program
+void SymbolMap::reset(const std::vector<std::string> &names) {
+    this->names = &names;
+    variables.assign(names.size(), Variable());
+    values.assign(names.size(), 0);
+    arrays.assign(names.size(), ArrayStorage());
+}
+
+// Checks if the variable in the specified slot is declared
+bool SymbolMap::isDeclared(int slot) const {
+    return variables[slot].declared;
+}
+
+// Declares a new variable in the specified slot with type and array properties if it is an array
+// The variable is reset in place, an array reuses the buffers of its previous declaration
+void SymbolMap::declareVariable(int slot, Type type, bool isArray, int arraySize) {
+    Variable &variable = variables[slot];
+
+    variable.type = type;
+    variable.isArray = isArray;
+    variable.declared = true;
+    variable.initialized = false;
+    values[slot] = 0;
+
+    if (isArray) {
+        arrays[slot].reset(type, arraySize);
+    }
+}
+
+// Resets the array to zeroed and uninitialized elements
+void ArrayStorage::reset(Type type, int length) {
+    size_t words = ((size_t) length + 63) / 64;
+
+    this->isBool = type == Type::BOOL;
+    this->length = length;
+
+    if (isBool) {
+        bools.assign(words, 0);
+        ints.clear();
+    } else {
+        ints.assign(length, 0);
+        bools.clear();
+    }
+    initialized.assign(words, 0);
+}
+
+// Scans the initialization flags a word at a time for the first element that is not set
+int ArrayStorage::firstUninitialized(int from, int to) const {
+    for (int index = from; index < to; index = (index | 63) + 1) {
+        uint64_t missing = ~initialized[index >> 6] >> (index & 63);
+
+        if (missing) {
+            return std::min(to, index + __builtin_ctzll(missing));
+        }
+    }
+    return to;
+}
+
+// Sets the initialization flags of a range, whole words at once
+void ArrayStorage::markInitialized(int from, int to) {
+    for (int index = from; index < to; index = (index | 63) + 1) {
+        int last = std::min(to, (index | 63) + 1);
+        uint64_t bits = last - index == 64 ? ~uint64_t(0) : ((uint64_t(1) << (last - index)) - 1) << (index & 63);
+
+        initialized[index >> 6] |= bits;
+    }
+}
+
+// Returns the name of the variable in the specified slot
+const std::string &SymbolMap::getName(int slot) const {
+    return (*names)[slot];
+}
+
+// Throws the error for an access to an undeclared variable
+void SymbolMap::throwUndeclared(int slot) const {
+    std::string errMsg = "Error: Variable " + (*names)[slot] + " not initialized";
+    throw std::runtime_error(errMsg);
+}
+
+// Message of an access to an array element outside of [0, size)
+std::string outOfBoundsMessage(int index, int size) {
+    return "Array index out of bounds 0<=" + std::to_string(index) + "<" + std::to_string(size);
+}
+
+// Message of a read of a scalar variable that was never assigned
+std::string uninitializedMessage(const std::string &name) {
+    return "Variable" + name + " not initialized yet";
+}
+
+// Message of a read of an array element that was never assigned
+std::string uninitializedElementMessage(const std::string &name, int index) {
+    return "Array " + name + " value at " + std::to_string(index) + " not initialized yet";
+}
+
+// Throws a runtime error with the provided error message specifying line and colum
+void Interpreter::throwError(const std::string &message, Node *node) {
+    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column) + " type " + typeid(node).name();
+    throw std::runtime_error(errMsg);
+}
+
+// Assigns a value to a variable or array element
+// The TypeChecker guarantees that the value has the type of the variable
+void Interpreter::assignValue(Node *locNode, Node *exprNode) {
+    if (auto *idNode = node_cast<IdNode>(locNode)) {
+        // The declaration check and the initialized flag are only needed by the accesses
+        // that the InitAnalysis could not prove
+        if (!idNode->checked) {
+            symbolMap.value(idNode->slot) = evaluateExpr(exprNode);
+            return;
+        }
+
+        Variable &variable = symbolMap.getVariable(idNode->slot);
+        symbolMap.value(idNode->slot) = evaluateExpr(exprNode);
+        variable.initialized = true;
+    } else if (auto *arrayAccessNode = node_cast<ArrayAccessNode>(locNode)) {
+        ArrayStorage &array = symbolMap.getArray(arrayAccessNode->slot);
+        int index = evaluateExpr(arrayAccessNode->index);
+        int value = evaluateExpr(exprNode);
+
+        // Check the array index bounds (unless the RangeAnalysis proved the index in bounds)
+        if (arrayAccessNode->checkBounds && (index < 0 || index >= array.size())) {
+            throwError(outOfBoundsMessage(index, array.size()), arrayAccessNode);
+        }
+
+        array.store(index, value);
+    } else {
+        throwError("Invalid location node in assignment", locNode);
+    }
+}
+
+// Constructor: print statements write to the given sink, statements are timed when a profiler is given
+Interpreter::Interpreter(OutputSink &output, Profiler *profiler) : output(output), profiler(profiler) {}
+
+// Interpret the root program node
+void Interpreter::interpret(Node* node) {
+    if (auto *programNode = node_cast<ProgramNode>(node)) {
+        symbolMap.reset(programNode->variables);
+
+        Flow flow = profiler ? executeBlock<true>(programNode->block) : executeBlock<false>(programNode->block);
+
+        // A break that reaches the program is not enclosed in any loop
+        if (flow == Flow::BREAK) {
+            throw BreakException();
+        }
+    } else {
+        throwError("Program should start with a ProgramNode", node);
+    }
+}
+
+// Executes a block node
+template <bool Profile>
+Interpreter::Flow Interpreter::executeBlock(Node *blockNode) {
+    if (auto *block = node_cast<BlockNode>(blockNode)) {
+        if (Node *decls = block->decls) {
+            executeDecls(decls);
+        }
+
+        if (Node *stmts = block->stmts) {
+            return executeStmts<Profile>(stmts);
+        }
+    } else {
+        throwError("Invalid block node", blockNode);
+    }
+
+    return Flow::NORMAL;
+}
+
+// Executes a sequence of declarations
+void Interpreter::executeDecls(Node *declsNode) {
+    if (auto *decls = node_cast<DeclsNode>(declsNode)) {
+        for (Node *decl : *decls) {
+            executeDecl(decl);
+        }
+    } else {
+        throwError("Invalid declarations node", declsNode);
+    }
+}
+
+// Executes a single declaration
+void Interpreter::executeDecl(Node *declNode) {
+    if (auto *decl = node_cast<DeclNode>(declNode)) {
+        // Basic types
+        if (auto *basicType = node_cast<BasicTypeNode>(decl->type)) {
+            if (basicType->typeName == "integer") {
+                symbolMap.declareVariable(decl->slot, Type::INT);
+            } else if (basicType->typeName == "boolean") {
+                symbolMap.declareVariable(decl->slot, Type::BOOL);
+            } else {
+                throwError("Unknown basic type " + std::string(basicType->typeName), basicType);
+            }
+        // Array Types
+        } else if (auto *arrayType = node_cast<ArrayTypeNode>(decl->type)) {
+            if (auto *baseType = node_cast<BasicTypeNode>(arrayType->type)) {
+                if (baseType->typeName == "integer") {
+                    symbolMap.declareVariable(decl->slot, Type::INT, true, arrayType->arraySize);
+                } else if (baseType->typeName == "boolean") {
+                    symbolMap.declareVariable(decl->slot, Type::BOOL, true, arrayType->arraySize);
+                } else {
+                    throwError("Unknown array base type " + std::string(baseType->typeName), baseType);
+                }
+            } else {
+                throwError("Invalid array type", arrayType);
+            }
+        } else {
+            throwError("Invalid type node in declaration", decl);
+        }
+    } else {
+        throwError("Invalid declaration node", declNode);
+    }
+}
+
+// Executes a sequence of statements
+// Stops at the first statement that breaks and hands the break to the caller
+template <bool Profile>
+Interpreter::Flow Interpreter::executeStmts(Node *stmtsNode) {
+    if (auto *stmts = node_cast<StmtsNode>(stmtsNode)) {
+        for (Node *stmt : *stmts) {
+            if (executeStmt<Profile>(stmt) == Flow::BREAK) {
+                return Flow::BREAK;
+            }
+        }
+    } else {
+        throwError("Invalid statements node", stmtsNode);
+    }
+
+    return Flow::NORMAL;
+}
+
+// Executes a single statement
+template <bool Profile>
+Interpreter::Flow Interpreter::executeStmt(Node *stmtNode) {
+    Profiler::Scope<Profile> scope(profiler, stmtNode);
+
+    switch (stmtNode->kind) {
+        // Assign
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            assignValue(assign->loc, assign->expr);
+            break;
+        }
+        // If
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            if (evaluateExpr(ifStmt->condition)) {
+                return executeStmt<Profile>(ifStmt->ifStmt);
+            }
+            break;
+        }
+        // If Else
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            if (evaluateExpr(ifElseStmt->condition)) {
+                return executeStmt<Profile>(ifElseStmt->ifStmt);
+            } else {
+                return executeStmt<Profile>(ifElseStmt->elseStmt);
+            }
+        }
+        // While
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+
+            // The kernel runs the iterations it can at once, the loop goes on from the first one left.
+            // Profiled runs keep the statements to time them.
+            if (!Profile && whileStmt->vector) {
+                whileStmt->vector->run(symbolMap);
+            }
+
+            while (evaluateExpr(whileStmt->condition)) {
+                if (executeStmt<Profile>(whileStmt->body) == Flow::BREAK) {
+                    break; // Exit from the cycle
+                }
+            }
+            break;
+        }
+        // Do While
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            do {
+                if (executeStmt<Profile>(doWhileStmt->body) == Flow::BREAK) {
+                    break; // Exit from the cycle
+                }
+            } while (evaluateExpr(doWhileStmt->condition));
+            break;
+        }
+        // Print
+        case NodeKind::PRINT: {
+            Node *expr = static_cast<PrintNode *>(stmtNode)->expr;
+            int value = evaluateExpr(expr);
+
+            if (expr->valueType == ValueType::INT) {
+                output.printInt(value);
+            } else {
+                output.printBool(value);
+            }
+            break;
+        }
+        // Break
+        case NodeKind::BREAK:
+            return Flow::BREAK;
+        // Block
+        case NodeKind::BLOCK:
+            return executeBlock<Profile>(stmtNode);
+        default:
+            throwError("Unknown statement type", stmtNode);
+    }
+
+    return Flow::NORMAL;
+}
+
+// Evaluates an expression, booleans are returned as 0 or 1.
+// Each node is checked by the TypeChecker, so the operations switch on the static type
+// of the node and never compare the types of the operands.
+int Interpreter::evaluateExpr(Node *exprNode) {
+    switch (exprNode->kind) {
+        // Multiplication
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            int left = evaluateExpr(mulNode->left);
+            int right = evaluateExpr(mulNode->right);
+
+            if (mulNode->isMultiplication) {
+                return mulNode->valueType == ValueType::INT ? wrapMul(left, right) : left & right;
+            }
+
+            if (right == 0) {
+                throwError("Impossible dividing by 0", mulNode);
+            }
+
+            return mulNode->valueType == ValueType::INT ? wrapDiv(left, right) : left;
+        }
+        // Addition
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            int left = evaluateExpr(addNode->left);
+            int right = evaluateExpr(addNode->right);
+
+            if (addNode->valueType == ValueType::INT) {
+                return addNode->isAddition ? wrapAdd(left, right) : wrapSub(left, right);
+            } else {
+                return addNode->isAddition ? left | right : left ^ right;
+            }
+        }
+        // Unary operation
+        case NodeKind::UNARY: {
+            auto *unaryNode = static_cast<UnaryNode *>(exprNode);
+            int operand = evaluateExpr(unaryNode->operand);
+
+            return unaryNode->op == UnaryNode::NOT ? !operand : wrapNeg(operand);
+        }
+        // Factor
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            switch (factorNode->type) {
+                case FactorNode::BOOL: return factorNode->boolValue;
+                case FactorNode::INT: return factorNode->intValue;
+                case FactorNode::ID: return evaluateExpr(factorNode->loc);
+            }
+            break;
+        }
+        // Or
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            return evaluateExpr(orNode->left) != 0 || evaluateExpr(orNode->right) != 0;
+        }
+        // And
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            return evaluateExpr(andNode->left) != 0 && evaluateExpr(andNode->right) != 0;
+        }
+        // Equality
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            int left = evaluateExpr(eqNode->left);
+            int right = evaluateExpr(eqNode->right);
+
+            return eqNode->isEqual == (left == right);
+        }
+        // Relation
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            int left = evaluateExpr(relNode->left);
+            int right = evaluateExpr(relNode->right);
+
+            switch (relNode->op) {
+                case RelNode::LESS: return left < right;
+                case RelNode::LESSEQ: return left <= right;
+                case RelNode::GREATER: return left > right;
+                case RelNode::GREATEREQ: return left >= right;
+            }
+            break;
+        }
+        // Id
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+
+            // Reads proven by the InitAnalysis skip the declaration and initialization checks
+            if (!idNode->checked) {
+                return symbolMap.value(idNode->slot);
+            }
+
+            if (!symbolMap.getVariable(idNode->slot).initialized) {
+                throwError(uninitializedMessage(std::string(idNode->id)), idNode);
+            }
+
+            return symbolMap.value(idNode->slot);
+        }
+        // Array access
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            ArrayStorage &array = symbolMap.getArray(arrayAccessNode->slot);
+            int index = evaluateExpr(arrayAccessNode->index);
+
+            // Check the array index bounds (unless the RangeAnalysis proved the index in bounds)
+            if (arrayAccessNode->checkBounds && (index < 0 || index >= array.size())) {
+                throwError(outOfBoundsMessage(index, array.size()), arrayAccessNode);
+            }
+
+            if (!array.isInitialized(index)) {
+                throwError(uninitializedElementMessage(std::string(arrayAccessNode->id), index), arrayAccessNode);
+            }
+
+            return array.load(index);
+        }
+        default:
+            throwError("Node interpretation not implemented yet", exprNode);
+    }
+
+    return 0; // Default value ( Should never be called )
+}
+
@@ -0,0 +1,310 @@
+// File created by fob
+
+#include "../include/invariantmotion.h"
+
+#include <string>
+
+// Symbol of the temporaries: they are made after the Resolver, so no interned identifier (which
+// all have a symbol >= 0) can be mistaken for one of them
+static constexpr int NO_SYMBOL = -1;
+
+// Constructor: new nodes are allocated in the arena owning the AST
+InvariantMotion::InvariantMotion(Arena &arena) : arena(arena) {}
+
+// Optimizes the loops of the root program node
+void InvariantMotion::optimize(Node *node) {
+    program = node_cast<ProgramNode>(node);
+    if (!program) {
+        return;
+    }
+
+    program->block = optimizeStmt(program->block);
+}
+
+// Marks the targets of the assignments and the declarations, which reset their variables
+void InvariantMotion::collectWrites(Node *node, std::vector<bool> &written) {
+    switch (node->kind) {
+        case NodeKind::ASSIGN: {
+            Node *loc = static_cast<AssignNode *>(node)->loc;
+            if (auto *idNode = node_cast<IdNode>(loc)) {
+                written[idNode->slot] = true;
+            } else if (auto *arrayAccessNode = node_cast<ArrayAccessNode>(loc)) {
+                written[arrayAccessNode->slot] = true;
+            }
+            break;
+        }
+        case NodeKind::IF:
+            collectWrites(static_cast<IfNode *>(node)->ifStmt, written);
+            break;
+        case NodeKind::IF_ELSE:
+            collectWrites(static_cast<IfElseNode *>(node)->ifStmt, written);
+            collectWrites(static_cast<IfElseNode *>(node)->elseStmt, written);
+            break;
+        case NodeKind::WHILE:
+            collectWrites(static_cast<WhileNode *>(node)->body, written);
+            break;
+        case NodeKind::DO_WHILE:
+            collectWrites(static_cast<DoWhileNode *>(node)->body, written);
+            break;
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(node);
+            if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+                for (Node *decl : *decls) {
+                    written[static_cast<DeclNode *>(decl)->slot] = true;
+                }
+            }
+            if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+                for (Node *stmt : *stmts) {
+                    collectWrites(stmt, written);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Walks the statements down to the loops. The invariant expressions of a loop are moved first,
+// then the loops nested in it are optimized on their own (smaller) sets of written variables.
+Node *InvariantMotion::optimizeStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            ifStmt->ifStmt = optimizeStmt(ifStmt->ifStmt);
+            return ifStmt;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            ifElseStmt->ifStmt = optimizeStmt(ifElseStmt->ifStmt);
+            ifElseStmt->elseStmt = optimizeStmt(ifElseStmt->elseStmt);
+            return ifElseStmt;
+        }
+        case NodeKind::BLOCK: {
+            if (auto *stmts = node_cast<StmtsNode>(static_cast<BlockNode *>(stmtNode)->stmts)) {
+                for (size_t i = 0; i < stmts->count; i++) {
+                    stmts->stmts[i] = optimizeStmt(stmts->stmts[i]);
+                }
+            }
+            return stmtNode;
+        }
+        case NodeKind::WHILE:
+        case NodeKind::DO_WHILE:
+            break;
+        default:
+            return stmtNode;
+    }
+
+    auto *whileStmt = node_cast<WhileNode>(stmtNode);
+    auto *doWhileStmt = node_cast<DoWhileNode>(stmtNode);
+    Node *&condition = whileStmt ? whileStmt->condition : doWhileStmt->condition;
+    Node *&body = whileStmt ? whileStmt->body : doWhileStmt->body;
+
+    written.assign(program->variables.size(), false);
+    collectWrites(body, written);
+    hoisted.clear();
+
+    if (moveExpr(condition)) {
+        hoist(condition);
+    }
+    moveStmt(body);
+
+    std::vector<std::pair<Node *, IdNode *>> moved = std::move(hoisted);
+    body = optimizeStmt(body);
+
+    if (moved.empty()) {
+        return stmtNode;
+    }
+
+    // The temporaries are assigned in a block that then runs the loop (profiled on the line of the loop)
+    std::vector<Node *> stmts;
+    for (const auto &[expr, temporary] : moved) {
+        stmts.push_back(arena.make<AssignNode>(Position{expr->line, expr->column}, temporary, expr));
+        stmts.back()->startLine = stmtNode->startLine;
+    }
+    stmts.push_back(stmtNode);
+
+    Position position{stmtNode->line, stmtNode->column};
+    auto *stmtsNode = arena.make<StmtsNode>(position, arena.copyArray(stmts.data(), stmts.size()), stmts.size());
+    auto *block = arena.make<BlockNode>(position, nullptr, stmtsNode);
+
+    block->startLine = stmtNode->startLine;
+    return block;
+}
+
+// Moves the invariant expressions out of a statement, nested loops included
+void InvariantMotion::moveStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            if (assign->loc->kind == NodeKind::ARRAY_ACCESS) {
+                moveExpr(assign->loc);
+            }
+            if (moveExpr(assign->expr)) {
+                hoist(assign->expr);
+            }
+            break;
+        }
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            if (moveExpr(ifStmt->condition)) {
+                hoist(ifStmt->condition);
+            }
+            moveStmt(ifStmt->ifStmt);
+            break;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            if (moveExpr(ifElseStmt->condition)) {
+                hoist(ifElseStmt->condition);
+            }
+            moveStmt(ifElseStmt->ifStmt);
+            moveStmt(ifElseStmt->elseStmt);
+            break;
+        }
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            if (moveExpr(whileStmt->condition)) {
+                hoist(whileStmt->condition);
+            }
+            moveStmt(whileStmt->body);
+            break;
+        }
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            moveStmt(doWhileStmt->body);
+            if (moveExpr(doWhileStmt->condition)) {
+                hoist(doWhileStmt->condition);
+            }
+            break;
+        }
+        case NodeKind::PRINT: {
+            auto *print = static_cast<PrintNode *>(stmtNode);
+            if (moveExpr(print->expr)) {
+                hoist(print->expr);
+            }
+            break;
+        }
+        case NodeKind::BLOCK: {
+            if (auto *stmts = node_cast<StmtsNode>(static_cast<BlockNode *>(stmtNode)->stmts)) {
+                for (Node *stmt : *stmts) {
+                    moveStmt(stmt);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// Decides bottom-up: an operation is invariant when its operands are and it cannot fail. The largest
+// invariant operands of an operation that is not are the ones moved out of the loop.
+bool InvariantMotion::moveExpr(Node *&exprNode) {
+    Node **left = nullptr;
+    Node **right = nullptr;
+    bool canFail = false;
+
+    switch (exprNode->kind) {
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            return factorNode->type != FactorNode::ID || moveExpr(factorNode->loc);
+        }
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+            return !idNode->checked && !(idNode->slot < (int) written.size() && written[idNode->slot]);
+        }
+        case NodeKind::ARRAY_ACCESS: {
+            // The element may change or fail, only its index can be moved
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            if (moveExpr(arrayAccessNode->index)) {
+                hoist(arrayAccessNode->index);
+            }
+            return false;
+        }
+        case NodeKind::UNARY:
+            return moveExpr(static_cast<UnaryNode *>(exprNode)->operand);
+        case NodeKind::MUL: {
+            // A division fails unless its divisor is a literal other than 0 (false)
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            auto *divisor = node_cast<FactorNode>(mulNode->right);
+            canFail = !mulNode->isMultiplication && !(divisor && divisor->type == FactorNode::INT && divisor->intValue != 0)
+                                                 && !(divisor && divisor->type == FactorNode::BOOL && divisor->boolValue);
+            left = &mulNode->left;
+            right = &mulNode->right;
+            break;
+        }
+        case NodeKind::ADD:
+            left = &static_cast<AddNode *>(exprNode)->left;
+            right = &static_cast<AddNode *>(exprNode)->right;
+            break;
+        case NodeKind::OR:
+            left = &static_cast<OrNode *>(exprNode)->left;
+            right = &static_cast<OrNode *>(exprNode)->right;
+            break;
+        case NodeKind::AND:
+            left = &static_cast<AndNode *>(exprNode)->left;
+            right = &static_cast<AndNode *>(exprNode)->right;
+            break;
+        case NodeKind::EQUALITY:
+            left = &static_cast<EqualityNode *>(exprNode)->left;
+            right = &static_cast<EqualityNode *>(exprNode)->right;
+            break;
+        case NodeKind::REL:
+            left = &static_cast<RelNode *>(exprNode)->left;
+            right = &static_cast<RelNode *>(exprNode)->right;
+            break;
+        default:
+            return false;
+    }
+
+    bool leftInvariant = moveExpr(*left);
+    bool rightInvariant = moveExpr(*right);
+
+    if (leftInvariant && rightInvariant && !canFail) {
+        return true;
+    }
+
+    if (leftInvariant) {
+        hoist(*left);
+    }
+    if (rightInvariant) {
+        hoist(*right);
+    }
+    return false;
+}
+
+// Moves an operation into a temporary, shared by the copies of the same expression in the loop
+void InvariantMotion::hoist(Node *&exprNode) {
+    if (exprNode->kind == NodeKind::FACTOR || exprNode->kind == NodeKind::ID) {
+        return;
+    }
+
+    IdNode *temporary = nullptr;
+    for (const auto &[expr, moved] : hoisted) {
+        if (sameExpr(expr, exprNode)) {
+            temporary = moved;
+            break;
+        }
+    }
+
+    // A new slot named $t<n>, a name no identifier can have, whose reads are all proven
+    if (!temporary) {
+        std::string name = "$t" + std::to_string(program->variables.size());
+        const char *text = arena.copyArray(name.data(), name.size());
+        int slot = (int) program->variables.size();
+
+        program->variables.push_back(name);
+        temporary = arena.make<IdNode>(Position{exprNode->line, exprNode->column}, NO_SYMBOL, std::string_view(text, name.size()));
+        temporary->slot = slot;
+        temporary->checked = false;
+        temporary->valueType = exprNode->valueType;
+        hoisted.emplace_back(exprNode, temporary);
+    }
+
+    IdNode *read = arena.make<IdNode>(Position{exprNode->line, exprNode->column}, NO_SYMBOL, temporary->id);
+    read->slot = temporary->slot;
+    read->checked = false;
+    read->valueType = temporary->valueType;
+    exprNode = read;
+}
@@ -0,0 +1,340 @@
+// File created by fob
+
+#include "../include/jit.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/mman.h>
+#define IEC_HAS_JIT 1
+#endif
+
+// Destructor: releases the machine code
+JIT::~JIT() {
+#ifdef IEC_HAS_JIT
+    if (machineCode) {
+        munmap(machineCode, machineCodeSize);
+    }
+#endif
+}
+
+// Appends raw bytes to the machine code
+void JIT::emit(std::initializer_list<uint8_t> bytes) {
+    buffer.insert(buffer.end(), bytes);
+}
+
+// Appends a little endian 32-bit immediate
+void JIT::emit32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back((uint8_t) (value >> (8 * i)));
+    }
+}
+
+// Appends a little endian 64-bit immediate
+void JIT::emit64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        buffer.push_back((uint8_t) (value >> (8 * i)));
+    }
+}
+
+// Appends an instruction addressing a register of the VM, the displacement from rbx follows the ModRM byte
+void JIT::emitRegister(std::initializer_list<uint8_t> opcode, int reg) {
+    emit(opcode);
+    emit32((uint32_t) reg * 4);
+}
+
+// Appends a jump to the template of an instruction, the displacement is patched once every template is placed
+void JIT::emitJump(uint8_t condition, int target) {
+    if (condition) {
+        emit({0x0F, condition});    // jcc rel32
+    } else {
+        emit({0xE9});               // jmp rel32
+    }
+    jumps.emplace_back(buffer.size(), target);
+    emit32(0);
+}
+
+// Appends a jump to an exit stub, the stubs are placed after the templates
+void JIT::emitExit(uint8_t condition, Exit exit, int pc) {
+    if (condition) {
+        emit({0x0F, condition});    // jcc rel32
+    } else {
+        emit({0xE9});               // jmp rel32
+    }
+    stubJumps.emplace_back(buffer.size(), (uint64_t) exit << 32 | (uint32_t) pc);
+    emit32(0);
+}
+
+// Translates the chunk: prologue, one template per instruction, epilogue and exit stubs
+bool JIT::compile(const Chunk &chunk) {
+#ifndef IEC_HAS_JIT
+    (void) chunk;
+    return false;
+#else
+    this->chunk = &chunk;
+    buffer.clear();
+    labels.assign(chunk.code.size(), 0);
+    jumps.clear();
+    stubJumps.clear();
+
+    // Prologue: the execution goes in r12, the registers in rbx and the scalar values in r13.
+    // They are callee saved, and three pushes keep the stack aligned for the calls to slowPath.
+    emit({0x53, 0x41, 0x54, 0x41, 0x55});   // push rbx; push r12; push r13
+    emit({0x49, 0x89, 0xFC});               // mov r12, rdi
+    emit({0x48, 0x89, 0xF3});               // mov rbx, rsi
+    emit({0x49, 0x89, 0xD5});               // mov r13, rdx
+
+    for (size_t pc = 0; pc < chunk.code.size(); pc++) {
+        labels[pc] = buffer.size();
+        compileInstruction(chunk.code[pc], (int) pc);
+    }
+
+    // Epilogue: rax holds the exit and the pc
+    size_t epilogue = buffer.size();
+    emit({0x41, 0x5D, 0x41, 0x5C, 0x5B});   // pop r13; pop r12; pop rbx
+    emit({0xC3});                           // ret
+
+    auto patch = [this](size_t at, size_t target) {
+        int32_t displacement = (int32_t) ((int64_t) target - (int64_t) (at + 4));
+        std::memcpy(&buffer[at], &displacement, 4);
+    };
+
+    // Exit stubs: load the exit and the pc in rax and leave
+    for (const auto &stubJump : stubJumps) {
+        patch(stubJump.first, buffer.size());
+        emit({0x48, 0xB8});                 // mov rax, imm64
+        emit64(stubJump.second);
+        emit({0xE9});                       // jmp epilogue
+        emit32((uint32_t) ((int64_t) epilogue - (int64_t) (buffer.size() + 4)));
+    }
+
+    for (const auto &jump : jumps) {
+        patch(jump.first, labels[jump.second]);
+    }
+
+    // The code is written in a writable mapping, which is then made executable (and read only)
+    size_t size = buffer.size();
+    void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    std::memcpy(mapping, buffer.data(), size);
+    if (mprotect(mapping, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(mapping, size);
+        return false;
+    }
+
+    if (machineCode) {
+        munmap(machineCode, machineCodeSize);
+    }
+    machineCode = static_cast<uint8_t *>(mapping);
+    machineCodeSize = size;
+    buffer = std::vector<uint8_t>();
+
+    return true;
+#endif
+}
+
+// Returns the second opcode byte of the jcc rel32 taken by a fused compare and branch
+static uint8_t jumpCondition(OpCode op) {
+    switch (op) {
+        case OpCode::JUMP_IF_LESS:
+        case OpCode::JUMP_IF_LESS_INT:          return 0x8C;    // jl
+        case OpCode::JUMP_IF_LESSEQ:
+        case OpCode::JUMP_IF_LESSEQ_INT:        return 0x8E;    // jle
+        case OpCode::JUMP_IF_GREATER:
+        case OpCode::JUMP_IF_GREATER_INT:       return 0x8F;    // jg
+        case OpCode::JUMP_IF_GREATEREQ:
+        case OpCode::JUMP_IF_GREATEREQ_INT:     return 0x8D;    // jge
+        case OpCode::JUMP_IF_EQ:
+        case OpCode::JUMP_IF_EQ_INT:            return 0x84;    // je
+        default:                                return 0x85;    // jne
+    }
+}
+
+// Translates a single instruction (eax and ecx are scratch registers)
+void JIT::compileInstruction(const Instruction &instruction, int pc) {
+    // Second opcode byte of setcc al for each comparison
+    uint8_t condition = 0;
+
+    switch (instruction.op) {
+        case OpCode::LOAD_INT:
+        case OpCode::LOAD_BOOL:
+            emitRegister({0xC7, 0x83}, instruction.a);     // mov dword [r(a)], imm32
+            emit32(instruction.op == OpCode::LOAD_INT ? (uint32_t) instruction.b : instruction.b != 0);
+            break;
+        case OpCode::LOAD_VAR_FAST:
+            emit({0x41, 0x8B, 0x85});                       // mov eax, [r13 + 4 * b]
+            emit32((uint32_t) instruction.b * 4);
+            emitRegister({0x89, 0x83}, instruction.a);     // mov [r(a)], eax
+            break;
+        case OpCode::STORE_VAR_FAST:
+            emitRegister({0x8B, 0x83}, instruction.b);     // mov eax, [r(b)]
+            emit({0x41, 0x89, 0x85});                       // mov [r13 + 4 * a], eax
+            emit32((uint32_t) instruction.a * 4);
+            break;
+        case OpCode::INC_VAR:
+            emit({0x41, 0x81, 0x85});                       // add dword [r13 + 4 * a], imm32
+            emit32((uint32_t) instruction.a * 4);
+            emit32((uint32_t) instruction.b);
+            break;
+        // Fused compare and branch: the flags of v(a) cmp v(b) (or cmp b) select the jump to c
+        case OpCode::JUMP_IF_LESS:
+        case OpCode::JUMP_IF_LESSEQ:
+        case OpCode::JUMP_IF_GREATER:
+        case OpCode::JUMP_IF_GREATEREQ:
+        case OpCode::JUMP_IF_EQ:
+        case OpCode::JUMP_IF_NEQ:
+            emit({0x41, 0x8B, 0x85});                       // mov eax, [r13 + 4 * a]
+            emit32((uint32_t) instruction.a * 4);
+            emit({0x41, 0x3B, 0x85});                       // cmp eax, [r13 + 4 * b]
+            emit32((uint32_t) instruction.b * 4);
+            emitJump(jumpCondition(instruction.op), instruction.c);
+            break;
+        case OpCode::JUMP_IF_LESS_INT:
+        case OpCode::JUMP_IF_LESSEQ_INT:
+        case OpCode::JUMP_IF_GREATER_INT:
+        case OpCode::JUMP_IF_GREATEREQ_INT:
+        case OpCode::JUMP_IF_EQ_INT:
+        case OpCode::JUMP_IF_NEQ_INT:
+            emit({0x41, 0x81, 0xBD});                       // cmp dword [r13 + 4 * a], imm32
+            emit32((uint32_t) instruction.a * 4);
+            emit32((uint32_t) instruction.b);
+            emitJump(jumpCondition(instruction.op), instruction.c);
+            break;
+        // Binary operations: eax = r(b) op r(c), booleans are 0 or 1 so or, xor and and implement +, - and *
+        case OpCode::ADD:
+        case OpCode::SUB:
+        case OpCode::MUL:
+        case OpCode::ADD_BOOL:
+        case OpCode::SUB_BOOL:
+        case OpCode::MUL_BOOL:
+            emitRegister({0x8B, 0x83}, instruction.b);     // mov eax, [r(b)]
+            switch (instruction.op) {
+                case OpCode::ADD:      emitRegister({0x03, 0x83}, instruction.c); break;          // add eax, [r(c)]
+                case OpCode::SUB:      emitRegister({0x2B, 0x83}, instruction.c); break;          // sub eax, [r(c)]
+                case OpCode::MUL:      emitRegister({0x0F, 0xAF, 0x83}, instruction.c); break;    // imul eax, [r(c)]
+                case OpCode::ADD_BOOL: emitRegister({0x0B, 0x83}, instruction.c); break;          // or eax, [r(c)]
+                case OpCode::SUB_BOOL: emitRegister({0x33, 0x83}, instruction.c); break;          // xor eax, [r(c)]
+                default:               emitRegister({0x23, 0x83}, instruction.c); break;          // and eax, [r(c)]
+            }
+            emitRegister({0x89, 0x83}, instruction.a);     // mov [r(a)], eax
+            break;
+        case OpCode::DIV:
+        case OpCode::DIV_BOOL:
+            emitRegister({0x8B, 0x8B}, instruction.c);     // mov ecx, [r(c)]
+            emit({0x85, 0xC9});                             // test ecx, ecx
+            emitExit(0x84, Exit::DIVISION_BY_ZERO, pc);     // jz division by zero
+            emitRegister({0x8B, 0x83}, instruction.b);     // mov eax, [r(b)]
+            if (instruction.op == OpCode::DIV) {
+                // x / -1 is negated: idiv traps on INT_MIN / -1, which wraps to INT_MIN
+                emit({0x83, 0xF9, 0xFF});                   // cmp ecx, -1
+                emit({0x75, 0x04});                         // jne idiv
+                emit({0xF7, 0xD8});                         // neg eax
+                emit({0xEB, 0x03});                         // jmp done
+                emit({0x99, 0xF7, 0xF9});                   // idiv: cdq; idiv ecx
+            }                                               // done
+            emitRegister({0x89, 0x83}, instruction.a);     // mov [r(a)], eax
+            break;
+        // Comparisons: eax = r(b) cmp r(c) as 0 or 1
+        case OpCode::EQ:        condition = 0x94; break;
+        case OpCode::NEQ:       condition = 0x95; break;
+        case OpCode::LESS:      condition = 0x9C; break;
+        case OpCode::LESSEQ:    condition = 0x9E; break;
+        case OpCode::GREATER:   condition = 0x9F; break;
+        case OpCode::GREATEREQ: condition = 0x9D; break;
+        // Conversions to boolean: eax = r(b) == 0 or r(b) != 0
+        case OpCode::NOT:
+        case OpCode::TO_BOOL:
+            emitRegister({0x8B, 0x83}, instruction.b);     // mov eax, [r(b)]
+            emit({0x85, 0xC0});                             // test eax, eax
+            emit({0x0F, (uint8_t) (instruction.op == OpCode::NOT ? 0x94 : 0x95), 0xC0});   // sete/setne al
+            emit({0x0F, 0xB6, 0xC0});                       // movzx eax, al
+            emitRegister({0x89, 0x83}, instruction.a);     // mov [r(a)], eax
+            break;
+        case OpCode::NEG:
+            emitRegister({0x8B, 0x83}, instruction.b);     // mov eax, [r(b)]
+            emit({0xF7, 0xD8});                             // neg eax
+            emitRegister({0x89, 0x83}, instruction.a);     // mov [r(a)], eax
+            break;
+        case OpCode::JUMP:
+            emitJump(0, instruction.a);
+            break;
+        case OpCode::JUMP_IF_FALSE:
+        case OpCode::JUMP_IF_TRUE:
+            emitRegister({0x83, 0xBB}, instruction.a);     // cmp dword [r(a)], 0
+            emit({0x00});
+            emitJump(instruction.op == OpCode::JUMP_IF_FALSE ? 0x84 : 0x85, instruction.b);
+            break;
+        case OpCode::BREAK:
+            emitExit(0, Exit::BREAK, pc);
+            break;
+        case OpCode::HALT:
+            emitExit(0, Exit::HALT, pc);
+            break;
+        // Instructions without a template: slowPath(jit, pc), leaving through an exit stub on errors
+        case OpCode::LOAD_VAR:
+        case OpCode::LOAD_ELEM:
+        case OpCode::LOAD_ELEM_FAST:
+        case OpCode::STORE_VAR:
+        case OpCode::STORE_ELEM:
+        case OpCode::STORE_ELEM_FAST:
+        case OpCode::ADD_ELEM:
+        case OpCode::ADD_ELEM_FAST:
+        case OpCode::VECTOR_LOOP:
+        case OpCode::CHECK_DECLARED:
+        case OpCode::DECLARE:
+        case OpCode::PRINT:
+            emit({0x4C, 0x89, 0xE7});                       // mov rdi, r12
+            emit({0xBE});                                   // mov esi, pc
+            emit32((uint32_t) pc);
+            emit({0x48, 0xB8});                             // mov rax, slowPath
+            emit64(reinterpret_cast<uint64_t>(&JIT::slowPath));
+            emit({0xFF, 0xD0});                             // call rax
+            emit({0x85, 0xC0});                             // test eax, eax
+            emitExit(0x85, Exit::ERROR, pc);                // jnz error
+            break;
+    }
+
+    if (condition) {
+        emitRegister({0x8B, 0x83}, instruction.b);         // mov eax, [r(b)]
+        emitRegister({0x3B, 0x83}, instruction.c);         // cmp eax, [r(c)]
+        emit({0x0F, condition, 0xC0});                      // setcc al
+        emit({0x0F, 0xB6, 0xC0});                           // movzx eax, al
+        emitRegister({0x89, 0x83}, instruction.a);         // mov [r(a)], eax
+    }
+}
+
+// Runs the machine code on a fresh execution and turns its exit into the end of the program or an exception
+void JIT::run(OutputSink &output) const {
+    Execution execution{*this, output, SymbolMap(), std::vector<int>(chunk->registerCount, 0), std::string()};
+    execution.symbolMap.reset(chunk->variables);
+
+    auto entry = reinterpret_cast<Entry>(machineCode);
+    uint64_t result = entry(&execution, execution.registers.data(), execution.symbolMap.valueData());
+    int pc = (int) (uint32_t) result;
+
+    switch ((Exit) (result >> 32)) {
+        case Exit::HALT:
+            return;
+        case Exit::ERROR:
+            throw std::runtime_error(execution.error);
+        case Exit::DIVISION_BY_ZERO:
+            VM::throwError("Impossible dividing by 0", *chunk, pc);
+        case Exit::BREAK:
+            throw Interpreter::BreakException();
+    }
+}
+
+// Runs an instruction for the machine code: exceptions are caught here and never reach it
+int JIT::slowPath(Execution *execution, int pc) noexcept {
+    try {
+        VM::execute(*execution->jit.chunk, pc, execution->symbolMap, execution->registers.data(), execution->output);
+        return 0;
+    } catch (const std::exception &e) {
+        execution->error = e.what();
+        return 1;
+    }
+}
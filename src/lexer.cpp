@@ -1,225 +1,342 @@
-// File created by fob
-
-#include "../include/lexer.h"
-
-#include <cctype>
-
-// Constructor: Initializes the lexer and reads the first character from input.
-Lexer::Lexer(std::ifstream &input) : input(input) {
-    // Initialize reserved keywords in the language.
-    keywords = {
-            {"int", Token::INT},
-            {"boolean", Token::BOOLEAN},
-            {"true", Token::TRUE},
-            {"false", Token::FALSE},
-            {"if", Token::IF},
-            {"else", Token::ELSE},
-            {"while", Token::WHILE},
-            {"do", Token::DO},
-            {"break", Token::BREAK},
-            {"print", Token::PRINT},
-    };
-
-    // Start lexing by reading the first character.
-    advance();
-}
-
-// Advances to the next character in the input file stream.
-// Handles line and column tracking for error reporting.
-void Lexer::advance() {
-    if (input.get(currentCharacter)) {
-        // Update position: reset column number on new lines.
-        if (currentCharacter == '\n') {
-            line++;
-            column = 0;
-        } else {
-            column++;
-        }
-    } else {
-        // If input stream ends, set current character to null character.
-        currentCharacter = '\0';
-    }
-}
-
-// Skips whitespace (spaces, tabs, newlines) to find the next meaningful character.
-void Lexer::skipWhitespace() {
-    while (isspace(currentCharacter)) {
-        advance();
-    }
-}
-
-// Recognizes and processes a numeric token. Supports integer numbers.
-// Advances the lexer through the input stream until a non-digit is found.
-Lexer::Token Lexer::scanNumber() {
-    numberValue = 0;
-
-    // Loop over the digits and build the integer value.
-    while (isdigit(currentCharacter)) {
-        numberValue = numberValue * 10 + (currentCharacter - '0');
-        advance();
-    }
-
-    return Token::NUM;
-}
-
-// Recognizes and processes either an identifier or a keyword token.
-// If the lexeme matches a keyword, returns the appropriate token.
-// Otherwise, returns Token::ID for identifiers.
-Lexer::Token Lexer::scanIdentifierOrKeyword() {
-    identifierValue.clear();
-
-    // Build identifier from alphanumeric characters.
-    while (isalnum(currentCharacter)) {
-        identifierValue += currentCharacter;
-        advance();
-    }
-
-    // Check if the lexeme is a keyword, otherwise it's an identifier.
-    auto keyword = keywords.find(identifierValue);
-    if (keyword != keywords.end()) {
-        return keyword->second;
-    }
-    return Token::ID;
-}
-
-// Main function to fetch the next token from the input stream.
-// Skips over whitespaces and matches single or multi-character tokens.
-Lexer::Token Lexer::nextToken() {
-    skipWhitespace();
-
-    // If the current character is a digit, it's part of a number.
-    if (isdigit(currentCharacter)) {
-        return scanNumber();
-    }
-    // If it's a letter, it could be an identifier or a keyword.
-    else if (isalpha(currentCharacter)) {
-        return scanIdentifierOrKeyword();
-    }
-    // Handle single and multi-character operators and delimiters.
-    else {
-        switch (currentCharacter) {
-            case '+': advance(); return Token::PLUS;
-            case '-': advance(); return Token::MINUS;
-            case '*': advance(); return Token::MULTIPLY;
-            case '/': advance(); return Token::DIVIDE;
-            case '=':
-                advance();
-                if (currentCharacter == '=') {
-                    advance();
-                    return Token::EQ;
-                }
-                return Token::ASSIGN;
-            case '!':
-                advance();
-                if (currentCharacter == '=') {
-                    advance();
-                    return Token::NEQ;
-                }
-                return Token::NOT;
-            case '<':
-                advance();
-                if (currentCharacter == '=') {
-                    advance();
-                    return Token::LESSEQ;
-                }
-                return Token::LESS;
-            case '>':
-                advance();
-                if (currentCharacter == '=') {
-                    advance();
-                    return Token::GREATEREQ;
-                }
-                return Token::GREATER;
-            case '&':
-                advance();
-                if (currentCharacter == '&') {
-                    advance();
-                    return Token::AND;
-                }
-                return Token::ERROR;
-            case '|':
-                advance();
-                if (currentCharacter == '|') {
-                    advance();
-                    return Token::OR;
-                }
-                return Token::ERROR;
-            case ';': advance(); return Token::SEMICOLON;
-            case '{': advance(); return Token::LBRACE;
-            case '}': advance(); return Token::RBRACE;
-            case '[': advance(); return Token::LBRACKET;
-            case ']': advance(); return Token::RBRACKET;
-            case '(': advance(); return Token::LPARENTHESIS;
-            case ')': advance(); return Token::RPARENTHESIS;
-            case '\0': return Token::END;
-            default: return Token::ERROR;
-        }
-    }
-}
-
-// Returns the numeric value of the current number token.
-int Lexer::getNumber() const {
-    return numberValue;
-}
-
-// Returns the string value of the current identifier token.
-std::string Lexer::getIdentifier() const {
-    return identifierValue;
-}
-
-// Returns the current line number.
-int Lexer::getLine() const {
-    return line;
-}
-
-// Returns the current column number.
-int Lexer::getColumn() const {
-    return column;
-}
-
-// Converts the current state of the lexer (line and column) to a string.
-std::string to_string(const Lexer &lexer) {
-    return "line: " + std::to_string(lexer.getLine()) + " column: " + std::to_string(lexer.getColumn());
-}
-
-// Converts a Token enum to its string representation.
-std::string to_string(const Lexer::Token token) {
-    switch (token) {
-        case Lexer::Token::NUM:          return "NUM";
-        case Lexer::Token::ID:           return "ID";
-        case Lexer::Token::INT:          return "INT";
-        case Lexer::Token::BOOLEAN:      return "BOOLEAN";
-        case Lexer::Token::TRUE:         return "TRUE";
-        case Lexer::Token::FALSE:        return "FALSE";
-        case Lexer::Token::LBRACE:       return "LBRACE";
-        case Lexer::Token::RBRACE:       return "RBRACE";
-        case Lexer::Token::LBRACKET:     return "LBRACKET";
-        case Lexer::Token::RBRACKET:     return "RBRACKET";
-        case Lexer::Token::LPARENTHESIS: return "LPARENTHESIS";
-        case Lexer::Token::RPARENTHESIS: return "RPARENTHESIS";
-        case Lexer::Token::SEMICOLON:    return "SEMICOLON";
-        case Lexer::Token::IF:           return "IF";
-        case Lexer::Token::ELSE:         return "ELSE";
-        case Lexer::Token::WHILE:        return "WHILE";
-        case Lexer::Token::DO:           return "DO";
-        case Lexer::Token::BREAK:        return "BREAK";
-        case Lexer::Token::PRINT:        return "PRINT";
-        case Lexer::Token::EQ:           return "EQ";
-        case Lexer::Token::NEQ:          return "NEQ";
-        case Lexer::Token::AND:          return "AND";
-        case Lexer::Token::OR:           return "OR";
-        case Lexer::Token::LESS:         return "LESS";
-        case Lexer::Token::LESSEQ:       return "LESSEQ";
-        case Lexer::Token::GREATER:      return "GREATER";
-        case Lexer::Token::GREATEREQ:    return "GREATEREQ";
-        case Lexer::Token::ASSIGN:       return "ASSIGN";
-        case Lexer::Token::PLUS:         return "PLUS";
-        case Lexer::Token::MINUS:        return "MINUS";
-        case Lexer::Token::MULTIPLY:     return "MULTIPLY";
-        case Lexer::Token::DIVIDE:       return "DIVIDE";
-        case Lexer::Token::NOT:          return "NOT";
-        case Lexer::Token::END:          return "END";
-        case Lexer::Token::ERROR:        return "ERROR";
-    }
-    return "UNKNOWN";
-}
+// File created by fob
+
+#include "../include/lexer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+// Constructor: Initializes the lexer and positions it on the first character of the source.
+Lexer::Lexer(std::string_view source, Interner &interner) : interner(interner) {
+    reset(source);
+}
+
+// Constructor: Reads the whole stream into the owned buffer and lexes it from memory.
+Lexer::Lexer(std::ifstream &input, Interner &interner) : Lexer(std::string_view(), interner) {
+    buffer.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    reset(buffer);
+}
+
+// Recognizes the reserved keywords of the language by switching on length and first character,
+// returns Token::ID for any other lexeme.
+static Lexer::Token keywordToken(std::string_view lexeme) {
+    switch (lexeme.size()) {
+        case 2:
+            if (lexeme == "if") return Lexer::Token::IF;
+            if (lexeme == "do") return Lexer::Token::DO;
+            break;
+        case 3:
+            if (lexeme == "int") return Lexer::Token::INT;
+            break;
+        case 4:
+            switch (lexeme[0]) {
+                case 't': if (lexeme == "true") return Lexer::Token::TRUE; break;
+                case 'e': if (lexeme == "else") return Lexer::Token::ELSE; break;
+            }
+            break;
+        case 5:
+            switch (lexeme[0]) {
+                case 'f': if (lexeme == "false") return Lexer::Token::FALSE; break;
+                case 'w': if (lexeme == "while") return Lexer::Token::WHILE; break;
+                case 'b': if (lexeme == "break") return Lexer::Token::BREAK; break;
+                case 'p': if (lexeme == "print") return Lexer::Token::PRINT; break;
+            }
+            break;
+        case 7:
+            if (lexeme == "boolean") return Lexer::Token::BOOLEAN;
+            break;
+    }
+    return Lexer::Token::ID;
+}
+
+// Starts scanning a new source buffer from its first character.
+void Lexer::reset(std::string_view source) {
+    start = source.data();
+    cursor = start;
+    end = start + source.size();
+    line = 1;
+    lineBegin = -1;
+    newlines.clear();
+
+    // A newline as first character already belongs to the second line.
+    if (cursor < end && *cursor == '\n') {
+        line++;
+        lineBegin = 0;
+        newlines.push_back(0);
+    }
+}
+
+// Returns the current character, or the null character at the end of the source.
+inline char Lexer::current() const {
+    return cursor < end ? *cursor : '\0';
+}
+
+// Advances to the next character in the source buffer.
+// Handles line tracking for error reporting, columns are derived from the offset of the line.
+inline void Lexer::advance() {
+    if (cursor < end) {
+        ++cursor;
+
+        // Update position: a newline opens a new line.
+        if (cursor < end && *cursor == '\n') {
+            line++;
+            lineBegin = cursor - start;
+            newlines.push_back((uint32_t) lineBegin);
+        }
+    }
+}
+
+// Skips whitespace (spaces, tabs, newlines) to find the next meaningful character.
+void Lexer::skipWhitespace() {
+    while (isspace((unsigned char) current())) {
+        advance();
+    }
+}
+
+// Recognizes and processes a numeric token. Supports integer numbers.
+// Advances the lexer through the source until a non-digit is found.
+Lexer::Token Lexer::scanNumber() {
+    numberValue = 0;
+
+    // Loop over the digits and build the integer value.
+    while (isdigit((unsigned char) current())) {
+        numberValue = numberValue * 10 + (*cursor - '0');
+        advance();
+    }
+
+    return Token::NUM;
+}
+
+// Recognizes and processes either an identifier or a keyword token.
+// If the lexeme matches a keyword, returns the appropriate token.
+// Otherwise, returns Token::ID for identifiers.
+Lexer::Token Lexer::scanIdentifierOrKeyword() {
+    const char *begin = cursor;
+
+    // The lexeme is the run of alphanumeric characters, sliced from the source without copies.
+    while (isalnum((unsigned char) current())) {
+        advance();
+    }
+    std::string_view lexeme(begin, cursor - begin);
+
+    // Check if the lexeme is a keyword, otherwise it's an identifier to intern.
+    Token token = keywordToken(lexeme);
+    if (token == Token::ID) {
+        symbolValue = interner.intern(lexeme);
+    }
+    return token;
+}
+
+// Main function to fetch the next token from the input stream.
+// Skips over whitespaces and matches single or multi-character tokens.
+Lexer::Token Lexer::nextToken() {
+    skipWhitespace();
+
+    char currentCharacter = current();
+
+    // If the current character is a digit, it's part of a number.
+    if (isdigit((unsigned char) currentCharacter)) {
+        return scanNumber();
+    }
+    // If it's a letter, it could be an identifier or a keyword.
+    else if (isalpha((unsigned char) currentCharacter)) {
+        return scanIdentifierOrKeyword();
+    }
+    // Handle single and multi-character operators and delimiters.
+    else {
+        switch (currentCharacter) {
+            case '+': advance(); return Token::PLUS;
+            case '-': advance(); return Token::MINUS;
+            case '*': advance(); return Token::MULTIPLY;
+            case '/': advance(); return Token::DIVIDE;
+            case '=':
+                advance();
+                if (current() == '=') {
+                    advance();
+                    return Token::EQ;
+                }
+                return Token::ASSIGN;
+            case '!':
+                advance();
+                if (current() == '=') {
+                    advance();
+                    return Token::NEQ;
+                }
+                return Token::NOT;
+            case '<':
+                advance();
+                if (current() == '=') {
+                    advance();
+                    return Token::LESSEQ;
+                }
+                return Token::LESS;
+            case '>':
+                advance();
+                if (current() == '=') {
+                    advance();
+                    return Token::GREATEREQ;
+                }
+                return Token::GREATER;
+            case '&':
+                advance();
+                if (current() == '&') {
+                    advance();
+                    return Token::AND;
+                }
+                return Token::ERROR;
+            case '|':
+                advance();
+                if (current() == '|') {
+                    advance();
+                    return Token::OR;
+                }
+                return Token::ERROR;
+            case ';': advance(); return Token::SEMICOLON;
+            case '{': advance(); return Token::LBRACE;
+            case '}': advance(); return Token::RBRACE;
+            case '[': advance(); return Token::LBRACKET;
+            case ']': advance(); return Token::RBRACKET;
+            case '(': advance(); return Token::LPARENTHESIS;
+            case ')': advance(); return Token::RPARENTHESIS;
+            case '\0': return Token::END;
+            default: return Token::ERROR;
+        }
+    }
+}
+
+// Scans the whole input into a token buffer.
+// Lexing stops after END or after the first ERROR token, which the parser will reject anyway.
+TokenBuffer Lexer::tokenize() {
+    TokenBuffer tokens;
+
+    for (;;) {
+        Token token = nextToken();
+
+        tokens.kinds.push_back(token);
+        tokens.values.push_back(token == Token::NUM ? numberValue : token == Token::ID ? symbolValue : 0);
+        tokens.offsets.push_back((uint32_t) (cursor - start));
+
+        if (token == Token::END || token == Token::ERROR) {
+            break;
+        }
+    }
+
+    tokens.newlines = newlines;
+    tokens.sourceSize = (uint32_t) (end - start);
+    tokens.interner = &interner;
+
+    return tokens;
+}
+
+// Returns the number of tokens in the buffer.
+size_t TokenBuffer::size() const {
+    return kinds.size();
+}
+
+// Returns the position reported by the lexer right after scanning the token at index.
+// Lines are found by binary search in the newline table, at the end of the source
+// the position stays on the last character.
+Position TokenBuffer::position(size_t index) const {
+    if (sourceSize == 0) {
+        return {1, 0};
+    }
+
+    uint32_t offset = offsets[index] < sourceSize ? offsets[index] : sourceSize - 1;
+    size_t newlinesBefore = std::upper_bound(newlines.begin(), newlines.end(), offset) - newlines.begin();
+    long lineBegin = newlinesBefore > 0 ? (long) newlines[newlinesBefore - 1] : -1;
+
+    return {(int) newlinesBefore + 1, (int) (offset - lineBegin)};
+}
+
+// Returns the line of the token at index: the line of its last character, a token never spans lines.
+int TokenBuffer::line(size_t index) const {
+    uint32_t offset = offsets[index] > 0 ? offsets[index] - 1 : 0;
+
+    return (int) (std::upper_bound(newlines.begin(), newlines.end(), offset) - newlines.begin()) + 1;
+}
+
+// Returns the numeric value of the current number token.
+int Lexer::getNumber() const {
+    return numberValue;
+}
+
+// Returns the string value of the current identifier token.
+std::string_view Lexer::getIdentifier() const {
+    return interner.name(symbolValue);
+}
+
+// Returns the interned symbol of the current identifier token.
+int Lexer::getSymbol() const {
+    return symbolValue;
+}
+
+// Returns the current line number.
+int Lexer::getLine() const {
+    return line;
+}
+
+// Returns the current column number.
+// At the end of the source the position stays on the last character.
+int Lexer::getColumn() const {
+    long offset = cursor - start;
+
+    if (cursor == end && offset > 0) {
+        offset--;
+    } else if (cursor == end) {
+        return 0;
+    }
+
+    return (int) (offset - lineBegin);
+}
+
+// Converts the current state of the lexer (line and column) to a string.
+std::string to_string(const Lexer &lexer) {
+    return "line: " + std::to_string(lexer.getLine()) + " column: " + std::to_string(lexer.getColumn());
+}
+
+// Converts a position to a string.
+std::string to_string(const Position &position) {
+    return "line: " + std::to_string(position.line) + " column: " + std::to_string(position.column);
+}
+
+// Converts a Token enum to its string representation.
+std::string to_string(const Lexer::Token token) {
+    switch (token) {
+        case Lexer::Token::NUM:          return "NUM";
+        case Lexer::Token::ID:           return "ID";
+        case Lexer::Token::INT:          return "INT";
+        case Lexer::Token::BOOLEAN:      return "BOOLEAN";
+        case Lexer::Token::TRUE:         return "TRUE";
+        case Lexer::Token::FALSE:        return "FALSE";
+        case Lexer::Token::LBRACE:       return "LBRACE";
+        case Lexer::Token::RBRACE:       return "RBRACE";
+        case Lexer::Token::LBRACKET:     return "LBRACKET";
+        case Lexer::Token::RBRACKET:     return "RBRACKET";
+        case Lexer::Token::LPARENTHESIS: return "LPARENTHESIS";
+        case Lexer::Token::RPARENTHESIS: return "RPARENTHESIS";
+        case Lexer::Token::SEMICOLON:    return "SEMICOLON";
+        case Lexer::Token::IF:           return "IF";
+        case Lexer::Token::ELSE:         return "ELSE";
+        case Lexer::Token::WHILE:        return "WHILE";
+        case Lexer::Token::DO:           return "DO";
+        case Lexer::Token::BREAK:        return "BREAK";
+        case Lexer::Token::PRINT:        return "PRINT";
+        case Lexer::Token::EQ:           return "EQ";
+        case Lexer::Token::NEQ:          return "NEQ";
+        case Lexer::Token::AND:          return "AND";
+        case Lexer::Token::OR:           return "OR";
+        case Lexer::Token::LESS:         return "LESS";
+        case Lexer::Token::LESSEQ:       return "LESSEQ";
+        case Lexer::Token::GREATER:      return "GREATER";
+        case Lexer::Token::GREATEREQ:    return "GREATEREQ";
+        case Lexer::Token::ASSIGN:       return "ASSIGN";
+        case Lexer::Token::PLUS:         return "PLUS";
+        case Lexer::Token::MINUS:        return "MINUS";
+        case Lexer::Token::MULTIPLY:     return "MULTIPLY";
+        case Lexer::Token::DIVIDE:       return "DIVIDE";
+        case Lexer::Token::NOT:          return "NOT";
+        case Lexer::Token::END:          return "END";
+        case Lexer::Token::ERROR:        return "ERROR";
+    }
+    return "UNKNOWN";
+}
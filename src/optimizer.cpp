@@ -0,0 +1,360 @@
+// File created by fob
+
+#include "../include/optimizer.h"
+
+
+// Constructor: new nodes are allocated in the arena owning the AST
+Optimizer::Optimizer(Arena &arena) : arena(arena) {}
+
+// Optimizes the root program node
+void Optimizer::optimize(Node *node) {
+    if (auto *program = node_cast<ProgramNode>(node)) {
+        if (auto *block = node_cast<BlockNode>(program->block)) {
+            optimizeBlock(block);
+        }
+    }
+}
+
+// Optimizes the statements of a block, dropping the ones that do nothing.
+// Declarations are kept: they reset their variables when they are executed.
+void Optimizer::optimizeBlock(BlockNode *block) {
+    auto *stmts = node_cast<StmtsNode>(block->stmts);
+    if (!stmts) {
+        return;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < stmts->count; i++) {
+        if (Node *stmt = optimizeStmt(stmts->stmts[i])) {
+            stmts->stmts[count++] = stmt;
+        }
+    }
+
+    stmts->count = count;
+    if (count == 0) {
+        block->stmts = nullptr;
+    }
+}
+
+// Optimizes a statement, returns nullptr when the statement can never do anything
+Node *Optimizer::optimizeStmt(Node *stmtNode) {
+    Result condition(false);
+
+    switch (stmtNode->kind) {
+        // Assign
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            assign->loc = optimizeExpr(assign->loc);
+            assign->expr = optimizeExpr(assign->expr);
+            return assign;
+        }
+        // If: a constant condition keeps only the branch it selects
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            ifStmt->condition = optimizeExpr(ifStmt->condition);
+
+            if (constantOf(ifStmt->condition, condition)) {
+                return condition.value ? optimizeStmt(ifStmt->ifStmt) : nullptr;
+            }
+
+            ifStmt->ifStmt = optimizeBody(ifStmt->ifStmt);
+            return ifStmt;
+        }
+        // If Else
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            ifElseStmt->condition = optimizeExpr(ifElseStmt->condition);
+
+            if (constantOf(ifElseStmt->condition, condition)) {
+                return optimizeStmt(condition.value ? ifElseStmt->ifStmt : ifElseStmt->elseStmt);
+            }
+
+            ifElseStmt->ifStmt = optimizeBody(ifElseStmt->ifStmt);
+            ifElseStmt->elseStmt = optimizeBody(ifElseStmt->elseStmt);
+            return ifElseStmt;
+        }
+        // While: a loop whose condition is always false never runs its body
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            whileStmt->condition = optimizeExpr(whileStmt->condition);
+
+            if (constantOf(whileStmt->condition, condition) && !condition.value) {
+                return nullptr;
+            }
+
+            whileStmt->body = optimizeBody(whileStmt->body);
+            return whileStmt;
+        }
+        // Do While: the body runs at least once and its breaks target this loop, so the loop is kept
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            doWhileStmt->body = optimizeBody(doWhileStmt->body);
+            doWhileStmt->condition = optimizeExpr(doWhileStmt->condition);
+            return doWhileStmt;
+        }
+        // Print
+        case NodeKind::PRINT: {
+            auto *print = static_cast<PrintNode *>(stmtNode);
+            print->expr = optimizeExpr(print->expr);
+            return print;
+        }
+        // Block
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(stmtNode);
+            optimizeBlock(block);
+            return block;
+        }
+        default:
+            return stmtNode;
+    }
+}
+
+// Optimizes a statement that cannot be removed from its parent, replacing it with an empty block
+Node *Optimizer::optimizeBody(Node *stmtNode) {
+    if (Node *stmt = optimizeStmt(stmtNode)) {
+        return stmt;
+    }
+
+    auto *block = arena.make<BlockNode>(Position{stmtNode->line, stmtNode->column}, nullptr, nullptr);
+
+    block->startLine = stmtNode->startLine;
+    return block;
+}
+
+// Optimizes an expression bottom-up
+Node *Optimizer::optimizeExpr(Node *exprNode) {
+    switch (exprNode->kind) {
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            mulNode->left = optimizeExpr(mulNode->left);
+            mulNode->right = optimizeExpr(mulNode->right);
+            return foldMul(mulNode);
+        }
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            addNode->left = optimizeExpr(addNode->left);
+            addNode->right = optimizeExpr(addNode->right);
+            return foldAdd(addNode);
+        }
+        case NodeKind::UNARY: {
+            auto *unaryNode = static_cast<UnaryNode *>(exprNode);
+            unaryNode->operand = optimizeExpr(unaryNode->operand);
+            return foldUnary(unaryNode);
+        }
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            orNode->left = optimizeExpr(orNode->left);
+            orNode->right = optimizeExpr(orNode->right);
+            return foldOr(orNode);
+        }
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            andNode->left = optimizeExpr(andNode->left);
+            andNode->right = optimizeExpr(andNode->right);
+            return foldAnd(andNode);
+        }
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            eqNode->left = optimizeExpr(eqNode->left);
+            eqNode->right = optimizeExpr(eqNode->right);
+            return foldEquality(eqNode);
+        }
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            relNode->left = optimizeExpr(relNode->left);
+            relNode->right = optimizeExpr(relNode->right);
+            return foldRel(relNode);
+        }
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            if (factorNode->type == FactorNode::ID) {
+                factorNode->loc = optimizeExpr(factorNode->loc);
+            }
+            return factorNode;
+        }
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            arrayAccessNode->index = optimizeExpr(arrayAccessNode->index);
+            return arrayAccessNode;
+        }
+        default:
+            return exprNode;
+    }
+}
+
+// Multiplication and division: x*1, 1*x and x/1 are x when x is an integer
+Node *Optimizer::foldMul(MulNode *node) {
+    Result left(0), right(0);
+    bool leftConstant = constantOf(node->left, left);
+    bool rightConstant = constantOf(node->right, right);
+
+    if (leftConstant && rightConstant) {
+        if (node->valueType == ValueType::BOOL) {
+            // Division by false fails at runtime
+            if (node->isMultiplication) {
+                return makeLiteral(Result((bool) (left.value && right.value)), node);
+            } else if (right.value) {
+                return makeLiteral(Result((bool) left.value), node);
+            }
+        } else if (node->isMultiplication) {
+            return makeLiteral(Result(wrapMul(left.value, right.value)), node);
+        } else if (right.value != 0) {
+            return makeLiteral(Result(wrapDiv(left.value, right.value)), node);
+        }
+
+        return node;
+    }
+
+    if (node->valueType != ValueType::INT) {
+        return node;
+    }
+    if (rightConstant && right.value == 1) {
+        return node->left;
+    }
+    if (node->isMultiplication && leftConstant && left.value == 1) {
+        return node->right;
+    }
+
+    return node;
+}
+
+// Addition and subtraction: x+0, 0+x and x-0 are x when x is an integer
+Node *Optimizer::foldAdd(AddNode *node) {
+    Result left(0), right(0);
+    bool leftConstant = constantOf(node->left, left);
+    bool rightConstant = constantOf(node->right, right);
+
+    if (leftConstant && rightConstant) {
+        if (node->valueType == ValueType::INT) {
+            return makeLiteral(Result(node->isAddition ? wrapAdd(left.value, right.value) : wrapSub(left.value, right.value)), node);
+        } else {
+            return makeLiteral(Result(node->isAddition ? (bool) (left.value || right.value) : left.value != right.value), node);
+        }
+    }
+
+    if (node->valueType != ValueType::INT) {
+        return node;
+    }
+    if (rightConstant && right.value == 0) {
+        return node->left;
+    }
+    if (node->isAddition && leftConstant && left.value == 0) {
+        return node->right;
+    }
+
+    return node;
+}
+
+// Unary operations: !!b is b when b is a boolean
+Node *Optimizer::foldUnary(UnaryNode *node) {
+    Result operand(0);
+
+    if (constantOf(node->operand, operand)) {
+        if (node->op == UnaryNode::NOT) {
+            return makeLiteral(Result(!operand.value), node);
+        } else {
+            return makeLiteral(Result(wrapNeg(operand.value)), node);
+        }
+    }
+
+    if (node->op == UnaryNode::NOT) {
+        auto *inner = node_cast<UnaryNode>(node->operand);
+        if (inner && inner->op == UnaryNode::NOT) {
+            return inner->operand;
+        }
+    }
+
+    return node;
+}
+
+// Or: true || e is true (e is never evaluated), false || e and e || false are e when e is a boolean
+Node *Optimizer::foldOr(OrNode *node) {
+    Result left(false), right(false);
+    bool rightConstant = constantOf(node->right, right);
+
+    if (constantOf(node->left, left)) {
+        if (left.value) {
+            return makeLiteral(Result(true), node);
+        } else if (rightConstant) {
+            return makeLiteral(Result((bool) right.value), node);
+        } else if (node->right->valueType == ValueType::BOOL) {
+            return node->right;
+        }
+    } else if (rightConstant && !right.value && node->left->valueType == ValueType::BOOL) {
+        return node->left;
+    }
+
+    return node;
+}
+
+// And: false && e is false (e is never evaluated), true && e and e && true are e when e is a boolean
+Node *Optimizer::foldAnd(AndNode *node) {
+    Result left(false), right(false);
+    bool rightConstant = constantOf(node->right, right);
+
+    if (constantOf(node->left, left)) {
+        if (!left.value) {
+            return makeLiteral(Result(false), node);
+        } else if (rightConstant) {
+            return makeLiteral(Result((bool) right.value), node);
+        } else if (node->right->valueType == ValueType::BOOL) {
+            return node->right;
+        }
+    } else if (rightConstant && right.value && node->left->valueType == ValueType::BOOL) {
+        return node->left;
+    }
+
+    return node;
+}
+
+// Equality between two literals
+Node *Optimizer::foldEquality(EqualityNode *node) {
+    Result left(0), right(0);
+
+    if (constantOf(node->left, left) && constantOf(node->right, right)) {
+        return makeLiteral(Result(node->isEqual == (left.value == right.value)), node);
+    }
+
+    return node;
+}
+
+// Relation between two literals, compared by value like the interpreter does
+Node *Optimizer::foldRel(RelNode *node) {
+    Result left(0), right(0);
+
+    if (constantOf(node->left, left) && constantOf(node->right, right)) {
+        switch (node->op) {
+            case RelNode::LESS: return makeLiteral(Result(left.value < right.value), node);
+            case RelNode::LESSEQ: return makeLiteral(Result(left.value <= right.value), node);
+            case RelNode::GREATER: return makeLiteral(Result(left.value > right.value), node);
+            case RelNode::GREATEREQ: return makeLiteral(Result(left.value >= right.value), node);
+        }
+    }
+
+    return node;
+}
+
+// Returns true and the value of a node if it is an INT or BOOL literal
+bool Optimizer::constantOf(Node *node, Result &value) {
+    auto *factorNode = node_cast<FactorNode>(node);
+    if (!factorNode) {
+        return false;
+    }
+
+    switch (factorNode->type) {
+        case FactorNode::INT: value = Result(factorNode->intValue); return true;
+        case FactorNode::BOOL: value = Result(factorNode->boolValue); return true;
+        default: return false;
+    }
+}
+
+// Creates a literal with the position of the node it replaces
+Node *Optimizer::makeLiteral(Result value, Node *at) {
+    Position position{at->line, at->column};
+
+    if (value.type == Type::INT) {
+        return arena.make<FactorNode>(position, FactorNode::INT, value.value, false, nullptr);
+    } else {
+        return arena.make<FactorNode>(position, FactorNode::BOOL, 0, (bool) value.value, nullptr);
+    }
+}
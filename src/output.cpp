@@ -0,0 +1,79 @@
+// File created by fob
+
+#include "../include/output.h"
+
+#include <charconv>
+#include <stdexcept>
+
+// Constructor: reserves the whole block up front
+OutputSink::OutputSink(std::ostream &out, FlushPolicy policy, size_t blockSize)
+    : out(out), policy(policy), blockSize(blockSize) {
+    buffer.reserve(blockSize);
+}
+
+// Destructor: writes the pending text
+OutputSink::~OutputSink() {
+    flush();
+}
+
+// Changes the flush policy
+void OutputSink::setPolicy(FlushPolicy policy) {
+    this->policy = policy;
+}
+
+// Prints an integer followed by a newline, formatting it without going through the stream
+void OutputSink::printInt(int value) {
+    char digits[16];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    buffer.append(digits, result.ptr);
+    endLine();
+}
+
+// Prints a boolean followed by a newline
+void OutputSink::printBool(bool value) {
+    buffer.append(value ? "true" : "false");
+    endLine();
+}
+
+// Writes the pending text to the stream and flushes it
+void OutputSink::flush() {
+    if (!buffer.empty()) {
+        out.write(buffer.data(), (std::streamsize) buffer.size());
+        buffer.clear();
+    }
+
+    out.flush();
+}
+
+// Terminates a printed line and applies the flush policy
+void OutputSink::endLine() {
+    buffer.push_back('\n');
+
+    switch (policy) {
+        case FlushPolicy::LINE:
+            flush();
+            break;
+        case FlushPolicy::BLOCK:
+            if (buffer.size() >= blockSize) {
+                out.write(buffer.data(), (std::streamsize) buffer.size());
+                buffer.clear();
+            }
+            break;
+        case FlushPolicy::EXIT:
+            break;
+    }
+}
+
+// Parses the name of a flush policy
+OutputSink::FlushPolicy parseFlushPolicy(const std::string &name) {
+    if (name == "line") {
+        return OutputSink::FlushPolicy::LINE;
+    } else if (name == "block") {
+        return OutputSink::FlushPolicy::BLOCK;
+    } else if (name == "exit") {
+        return OutputSink::FlushPolicy::EXIT;
+    }
+
+    throw std::runtime_error("Error: Unknown flush policy " + name + ". Expected line, block or exit");
+}
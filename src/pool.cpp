@@ -0,0 +1,90 @@
+// File created by fob
+
+#include "../include/pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+// Constructor
+WorkStealingPool::WorkStealingPool(unsigned threads) : threads(threads) {
+    if (this->threads == 0) {
+        this->threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+// Returns the number of workers
+unsigned WorkStealingPool::size() const {
+    return threads;
+}
+
+// Deals the tasks round robin, starts the workers and waits for them
+void WorkStealingPool::run(size_t count, const std::function<void(size_t)> &task) {
+    unsigned workers = (unsigned) std::min<size_t>(threads, count);
+    if (workers == 0) {
+        return;
+    }
+
+    std::vector<Queue> queues(workers);
+    for (size_t i = 0; i < count; i++) {
+        queues[i % workers].tasks.push_back(i);
+    }
+
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    auto work = [&](unsigned self) {
+        size_t index;
+
+        while (take(queues, self, index)) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < workers; i++) {
+        pool.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+// Takes a task from the front of the own queue, then from the back of the others
+bool WorkStealingPool::take(std::vector<Queue> &queues, unsigned self, size_t &index) {
+    {
+        Queue &own = queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+
+        if (!own.tasks.empty()) {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue &victim = queues[(self + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.tasks.empty()) {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
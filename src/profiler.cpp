@@ -0,0 +1,115 @@
+// File created by fob
+
+#include "../include/profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+// Returns whether no statement has been recorded
+bool Profiler::empty() const {
+    return stats.empty();
+}
+
+// Returns the number of statements executed so far
+uint64_t Profiler::executed() const {
+    uint64_t executed = 0;
+
+    for (const auto &entry : stats) {
+        executed += entry.second.count;
+    }
+
+    return executed;
+}
+
+// Returns the statistics of a statement, recording its details the first time
+Profiler::Stats &Profiler::statsOf(const Node *node) {
+    Stats &entry = stats[node];
+
+    if (entry.count == 0) {
+        entry.line = node->startLine;
+        entry.kind = node->kind;
+
+        if (node->kind == NodeKind::WHILE) {
+            entry.body = static_cast<const WhileNode *>(node)->body;
+        } else if (node->kind == NodeKind::DO_WHILE) {
+            entry.body = static_cast<const DoWhileNode *>(node)->body;
+        }
+    }
+
+    return entry;
+}
+
+// Prints the report: the statements of a line are summed up, a loop also shows how many times its body ran
+void Profiler::report(std::ostream &out, size_t limit) const {
+    // Statistics of a source line
+    struct Line {
+        int line;
+        uint64_t count = 0;
+        uint64_t selfTime = 0;
+    };
+
+    // Statistics of a loop statement
+    struct Loop {
+        Stats stats;
+        uint64_t iterations;
+    };
+
+    std::map<int, Line> lines;
+    std::vector<Loop> loops;
+    uint64_t executed = 0;
+    uint64_t selfTime = 0;
+
+    for (const auto &entry : stats) {
+        Line &line = lines[entry.second.line];
+
+        line.line = entry.second.line;
+        line.count += entry.second.count;
+        line.selfTime += entry.second.selfTime;
+        executed += entry.second.count;
+        selfTime += entry.second.selfTime;
+
+        if (entry.second.body) {
+            auto iterations = stats.find(entry.second.body);
+            loops.push_back(Loop{entry.second, iterations != stats.end() ? iterations->second.count : 0});
+        }
+    }
+
+    std::vector<Line> hotLines;
+    for (const auto &line : lines) {
+        hotLines.push_back(line.second);
+    }
+    std::stable_sort(hotLines.begin(), hotLines.end(), [](const Line &a, const Line &b) { return a.selfTime > b.selfTime; });
+    std::stable_sort(loops.begin(), loops.end(), [](const Loop &a, const Loop &b) { return a.stats.totalTime > b.stats.totalTime; });
+
+    auto ms = [](uint64_t ns) { return (double) ns / 1e6; };
+
+    out << std::fixed << std::setprecision(3);
+    out << "Profile: " << executed << " statements executed, " << ms(selfTime) << " ms\n";
+
+    out << "\nHottest lines by self time\n";
+    out << std::setw(8) << "line" << std::setw(14) << "count" << std::setw(12) << "self ms" << std::setw(9) << "self %" << "\n";
+    for (size_t i = 0; i < hotLines.size() && i < limit; i++) {
+        const Line &line = hotLines[i];
+        double percent = selfTime ? 100.0 * (double) line.selfTime / (double) selfTime : 0.0;
+
+        out << std::setw(8) << line.line << std::setw(14) << line.count << std::setw(12) << ms(line.selfTime)
+            << std::setw(8) << std::setprecision(1) << percent << "%" << std::setprecision(3) << "\n";
+    }
+
+    if (!loops.empty()) {
+        out << "\nHottest loops by total time\n";
+        out << std::setw(8) << "line" << std::setw(10) << "loop" << std::setw(10) << "runs" << std::setw(14) << "iterations"
+            << std::setw(12) << "total ms" << std::setw(12) << "self ms" << "\n";
+        for (size_t i = 0; i < loops.size() && i < limit; i++) {
+            const Loop &loop = loops[i];
+
+            out << std::setw(8) << loop.stats.line << std::setw(10) << (loop.stats.kind == NodeKind::WHILE ? "while" : "do-while")
+                << std::setw(10) << loop.stats.count << std::setw(14) << loop.iterations
+                << std::setw(12) << ms(loop.stats.totalTime) << std::setw(12) << ms(loop.stats.selfTime) << "\n";
+        }
+    }
+
+    out << std::defaultfloat << std::setprecision(6);
+}
@@ -0,0 +1,149 @@
+// File created by fob
+
+#include "../include/program.h"
+#include "../include/arena.h"
+#include "../include/compiler.h"
+#include "../include/initanalysis.h"
+#include "../include/interner.h"
+#include "../include/interpreter.h"
+#include "../include/invariantmotion.h"
+#include "../include/jit.h"
+#include "../include/lexer.h"
+#include "../include/optimizer.h"
+#include "../include/parser.h"
+#include "../include/rangeanalysis.h"
+#include "../include/resolver.h"
+#include "../include/source.h"
+#include "../include/typechecker.h"
+#include "../include/vectorizer.h"
+#include "../include/vm.h"
+
+#include <mutex>
+
+// Everything a Program owns. The chunk and the machine code are compiled by the first run needing them,
+// the once flags make the runs racing for them wait until they are ready.
+struct Program::Impl {
+    Interner interner;          // Names of the identifiers, viewed by the nodes
+    Arena arena;                // Nodes of the tree
+    Node *tree = nullptr;       // Root ProgramNode
+
+    std::once_flag chunkOnce;   // Guards the compilation of the chunk
+    Chunk chunk;                // Bytecode of the VM and the JIT
+    std::once_flag jitOnce;     // Guards the translation of the chunk
+    JIT jit;                    // Machine code of the chunk
+    bool jitReady = false;      // The machine code can run on this machine
+
+    // Returns the bytecode, compiling it the first time
+    const Chunk &compiled() {
+        std::call_once(chunkOnce, [this]() {
+            Compiler compiler;
+
+            chunk = compiler.compile(tree);
+        });
+
+        return chunk;
+    }
+
+    // Returns the machine code or nullptr when the JIT is not available, translating it the first time
+    const JIT *translated() {
+        const Chunk &code = compiled();
+
+        std::call_once(jitOnce, [this, &code]() {
+            jitReady = jit.compile(code);
+        });
+
+        return jitReady ? &jit : nullptr;
+    }
+
+    // Lexes, parses and checks a source, the nodes and the names they refer to stay in the Impl
+    void build(std::string_view source) {
+        Lexer lexer(source, interner);
+        TokenBuffer tokens = lexer.tokenize();
+        Parser parser(tokens);
+        Node *program = parser.parse();
+
+        analyze(program, parser.getArena());
+
+        arena = std::move(parser.getArena());
+        tree = program;
+    }
+};
+
+// Runs the passes in order, each one relying on the ones before it
+void Program::analyze(Node *tree, Arena &arena) {
+    Resolver resolver;
+    TypeChecker typeChecker;
+    Optimizer optimizer(arena);
+    InitAnalysis initAnalysis;
+    InvariantMotion invariantMotion(arena);
+    RangeAnalysis rangeAnalysis;
+    Vectorizer vectorizer(arena);
+
+    resolver.resolve(tree);
+    typeChecker.check(tree);
+    optimizer.optimize(tree);
+    initAnalysis.analyze(tree);
+    invariantMotion.optimize(tree);
+    rangeAnalysis.analyze(tree);
+    vectorizer.vectorize(tree);
+}
+
+// Constructor
+Program::Program(std::unique_ptr<Impl> impl) : impl(std::move(impl)) {}
+
+// Move operations and destructor, defined where Impl is complete
+Program::Program(Program &&other) noexcept = default;
+Program &Program::operator=(Program &&other) noexcept = default;
+Program::~Program() = default;
+
+// Builds the tree of a source text
+Program Program::fromSource(std::string_view source) {
+    auto impl = std::make_unique<Impl>();
+
+    impl->build(source);
+
+    return Program(std::move(impl));
+}
+
+// Builds the tree of a source file, through the cache when there is one
+Program Program::fromFile(const std::string &path, const ProgramCache *cache) {
+    SourceFile source(path);
+    auto impl = std::make_unique<Impl>();
+
+    impl->tree = cache ? cache->load(path, source.text(), impl->arena) : nullptr;
+
+    if (!impl->tree) {
+        impl->build(source.text());
+
+        if (cache) {
+            cache->store(path, source.text(), impl->tree);
+        }
+    }
+
+    return Program(std::move(impl));
+}
+
+// Runs the program on a fresh engine, only the compiled code is shared with the other runs
+void Program::run(OutputSink &output, Engine engine, Profiler *profiler) const {
+    if (engine == Engine::INTERPRETER) {
+        Interpreter interpreter(output, profiler);
+
+        interpreter.interpret(impl->tree);
+        return;
+    }
+
+    const JIT *jit = engine == Engine::JIT ? impl->translated() : nullptr;
+
+    if (jit) {
+        jit->run(output);
+    } else {
+        VM vm(output);
+
+        vm.run(impl->compiled());
+    }
+}
+
+// Returns the root ProgramNode
+const Node &Program::tree() const {
+    return *impl->tree;
+}
@@ -0,0 +1,539 @@
+// File created by fob
+
+#include "../include/rangeanalysis.h"
+
+#include <algorithm>
+#include <climits>
+
+// Analyzes the root program node
+void RangeAnalysis::analyze(Node *node) {
+    auto *program = node_cast<ProgramNode>(node);
+    if (!program) {
+        return;
+    }
+
+    size_t slots = program->variables.size();
+    state = State();
+    state.ranges.assign(slots, anyInt());
+    breakStates.clear();
+    arraySizes.assign(slots, -1);
+
+    collectSizes(program->block, arraySizes);
+    for (int &size : arraySizes) {
+        size = std::max(size, 0);
+    }
+
+    analyzeBlock(program->block);
+}
+
+// Returns the range holding any int value
+RangeAnalysis::Range RangeAnalysis::anyInt() {
+    return Range{INT_MIN, INT_MAX};
+}
+
+// Returns the range [low, high], the int operations wrap so a range that overflows may hold any value
+RangeAnalysis::Range RangeAnalysis::rangeOf(long long low, long long high) {
+    if (low < INT_MIN || high > INT_MAX) {
+        return anyInt();
+    }
+    return Range{low, high};
+}
+
+// Widens the ranges to hold the values of both paths, code that is not reachable adds no value
+void RangeAnalysis::merge(State &into, const State &from) {
+    if (!from.reachable) {
+        return;
+    }
+    if (!into.reachable) {
+        into = from;
+        return;
+    }
+
+    for (size_t slot = 0; slot < into.ranges.size(); slot++) {
+        into.ranges[slot].low = std::min(into.ranges[slot].low, from.ranges[slot].low);
+        into.ranges[slot].high = std::max(into.ranges[slot].high, from.ranges[slot].high);
+    }
+}
+
+// Returns the integer variable read by an expression (the parser builds plain IdNodes, a FactorNode may wrap one)
+IdNode *RangeAnalysis::variableOf(Node *node) {
+    auto *idNode = node_cast<IdNode>(unwrap(node));
+    return idNode && idNode->valueType == ValueType::INT ? idNode : nullptr;
+}
+
+// Records the smallest size each array is declared with inside a statement
+void RangeAnalysis::collectSizes(Node *node, std::vector<int> &sizes) {
+    switch (node->kind) {
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(node);
+            if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+                for (Node *decl : *decls) {
+                    auto *declNode = static_cast<DeclNode *>(decl);
+                    if (auto *arrayType = node_cast<ArrayTypeNode>(declNode->type)) {
+                        int &size = sizes[declNode->slot];
+                        size = size < 0 ? arrayType->arraySize : std::min(size, arrayType->arraySize);
+                    }
+                }
+            }
+            if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+                for (Node *stmt : *stmts) {
+                    collectSizes(stmt, sizes);
+                }
+            }
+            break;
+        }
+        case NodeKind::IF:
+            collectSizes(static_cast<IfNode *>(node)->ifStmt, sizes);
+            break;
+        case NodeKind::IF_ELSE:
+            collectSizes(static_cast<IfElseNode *>(node)->ifStmt, sizes);
+            collectSizes(static_cast<IfElseNode *>(node)->elseStmt, sizes);
+            break;
+        case NodeKind::WHILE:
+            collectSizes(static_cast<WhileNode *>(node)->body, sizes);
+            break;
+        case NodeKind::DO_WHILE:
+            collectSizes(static_cast<DoWhileNode *>(node)->body, sizes);
+            break;
+        default:
+            break;
+    }
+}
+
+// Records how the statement changes each variable: x = x + e, x = e + x and x = x - e are
+// steps in a single direction, any other assignment (or a declaration) may set any value
+void RangeAnalysis::collectSteps(Node *node, std::vector<Step> &steps) {
+    switch (node->kind) {
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(node);
+            if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+                for (Node *decl : *decls) {
+                    steps[static_cast<DeclNode *>(decl)->slot] = Step::ANY;
+                }
+            }
+            if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+                for (Node *stmt : *stmts) {
+                    collectSteps(stmt, steps);
+                }
+            }
+            break;
+        }
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(node);
+            auto *idNode = node_cast<IdNode>(assign->loc);
+            if (!idNode) {
+                break;
+            }
+
+            // The direction of a step by a non literal is a guess checked by analyzeBackEdge
+            Step step = Step::ANY;
+            auto *addNode = node_cast<AddNode>(assign->expr);
+            if (addNode && addNode->valueType == ValueType::INT) {
+                IdNode *left = variableOf(addNode->left);
+                IdNode *right = variableOf(addNode->right);
+                Node *other = nullptr;
+
+                if (left && left->slot == idNode->slot) {
+                    other = addNode->right;
+                } else if (addNode->isAddition && right && right->slot == idNode->slot) {
+                    other = addNode->left;
+                }
+
+                if (other) {
+                    auto *literal = node_cast<FactorNode>(other);
+                    long long delta = literal && literal->type == FactorNode::INT ? literal->intValue : 1;
+                    delta = addNode->isAddition ? delta : -delta;
+                    step = delta > 0 ? Step::INCREASING : delta < 0 ? Step::DECREASING : Step::NONE;
+                }
+            }
+
+            Step &current = steps[idNode->slot];
+            if (current == Step::NONE) {
+                current = step;
+            } else if (step != Step::NONE && step != current) {
+                current = Step::ANY;
+            }
+            break;
+        }
+        case NodeKind::IF:
+            collectSteps(static_cast<IfNode *>(node)->ifStmt, steps);
+            break;
+        case NodeKind::IF_ELSE:
+            collectSteps(static_cast<IfElseNode *>(node)->ifStmt, steps);
+            collectSteps(static_cast<IfElseNode *>(node)->elseStmt, steps);
+            break;
+        case NodeKind::WHILE:
+            collectSteps(static_cast<WhileNode *>(node)->body, steps);
+            break;
+        case NodeKind::DO_WHILE:
+            collectSteps(static_cast<DoWhileNode *>(node)->body, steps);
+            break;
+        default:
+            break;
+    }
+}
+
+// Analyzes a block: each declaration (re)declares its variable, whose value is unknown
+void RangeAnalysis::analyzeBlock(Node *blockNode) {
+    auto *block = node_cast<BlockNode>(blockNode);
+    if (!block) {
+        return;
+    }
+
+    if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+        for (Node *decl : *decls) {
+            state.ranges[static_cast<DeclNode *>(decl)->slot] = anyInt();
+        }
+    }
+
+    if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+        for (Node *stmt : *stmts) {
+            analyzeStmt(stmt);
+        }
+    }
+}
+
+// Moves the state to the head of a loop.
+// A variable only increased by the body keeps its lower bound at every iteration (and the
+// opposite for a decreased one), a variable set to other values may hold any value.
+// The guess is checked against the end of the body by analyzeBackEdge.
+void RangeAnalysis::analyzeLoopHead(Node *body) {
+    std::vector<Step> steps(state.ranges.size(), Step::NONE);
+    collectSteps(body, steps);
+
+    for (size_t slot = 0; slot < steps.size(); slot++) {
+        switch (steps[slot]) {
+            case Step::INCREASING:
+                state.ranges[slot].high = INT_MAX;
+                break;
+            case Step::DECREASING:
+                state.ranges[slot].low = INT_MIN;
+                break;
+            case Step::ANY:
+                state.ranges[slot] = anyInt();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// Checks that the head of a loop holds the state at the end of its body (the values of the
+// next iteration). When it does not (e.g. a step may wrap) the ranges that grew are dropped
+// and false is returned, so the body is analyzed again from the wider head.
+bool RangeAnalysis::analyzeBackEdge(State &head) {
+    if (!state.reachable || !head.reachable) {
+        return true;
+    }
+
+    bool holds = true;
+    for (size_t slot = 0; slot < head.ranges.size(); slot++) {
+        Range &range = head.ranges[slot];
+        if (state.ranges[slot].low < range.low || state.ranges[slot].high > range.high) {
+            range = anyInt();
+            holds = false;
+        }
+    }
+    return holds;
+}
+
+// Analyzes a single statement
+void RangeAnalysis::analyzeStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+
+            if (auto *idNode = node_cast<IdNode>(assign->loc)) {
+                state.ranges[idNode->slot] = analyzeExpr(assign->expr);
+            } else {
+                analyzeExpr(assign->loc);
+                analyzeExpr(assign->expr);
+            }
+            break;
+        }
+        // If: the branch runs with the condition true, the values after it are those of both paths
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            analyzeExpr(ifStmt->condition);
+
+            State skipped = state;
+            refine(ifStmt->condition);
+            analyzeStmt(ifStmt->ifStmt);
+            merge(state, skipped);
+            break;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            analyzeExpr(ifElseStmt->condition);
+
+            State elseState = state;
+            refine(ifElseStmt->condition);
+            analyzeStmt(ifElseStmt->ifStmt);
+            std::swap(state, elseState);
+            analyzeStmt(ifElseStmt->elseStmt);
+            merge(state, elseState);
+            break;
+        }
+        // While: the body runs with the condition true, the loop is left from the head or through a break
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            analyzeLoopHead(whileStmt->body);
+            State head = state;
+
+            while (true) {
+                state = head;
+                analyzeExpr(whileStmt->condition);
+                refine(whileStmt->condition);
+
+                breakStates.push_back(State{{}, false});
+                analyzeStmt(whileStmt->body);
+                if (analyzeBackEdge(head)) {
+                    break;
+                }
+                breakStates.pop_back();
+            }
+
+            merge(head, breakStates.back());
+            breakStates.pop_back();
+            state = head;
+            break;
+        }
+        // Do While: the loop is left after the body or through a break
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            analyzeLoopHead(doWhileStmt->body);
+            State head = state;
+
+            while (true) {
+                state = head;
+                breakStates.push_back(State{{}, false});
+                analyzeStmt(doWhileStmt->body);
+                analyzeExpr(doWhileStmt->condition);
+                if (analyzeBackEdge(head)) {
+                    break;
+                }
+                breakStates.pop_back();
+            }
+
+            merge(state, breakStates.back());
+            breakStates.pop_back();
+            break;
+        }
+        case NodeKind::PRINT:
+            analyzeExpr(static_cast<PrintNode *>(stmtNode)->expr);
+            break;
+        // Break: the values flow to the end of the enclosing loop, the next statements are unreachable
+        case NodeKind::BREAK:
+            if (!breakStates.empty()) {
+                merge(breakStates.back(), state);
+            }
+            state.reachable = false;
+            break;
+        case NodeKind::BLOCK:
+            analyzeBlock(stmtNode);
+            break;
+        default:
+            break;
+    }
+}
+
+// Analyzes an expression and returns the range of its value (booleans are 0 or 1)
+RangeAnalysis::Range RangeAnalysis::analyzeExpr(Node *exprNode) {
+    const Range boolean{0, 1};
+
+    switch (exprNode->kind) {
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            Range left = analyzeExpr(mulNode->left);
+            Range right = analyzeExpr(mulNode->right);
+            if (mulNode->valueType != ValueType::INT) {
+                return boolean;
+            }
+
+            // Unreachable code (refined to empty ranges) gives no bound, nor does a division by a range holding 0
+            if (!state.reachable || left.low > left.high || right.low > right.high) {
+                return anyInt();
+            }
+            if (!mulNode->isMultiplication && right.low <= 0 && right.high >= 0) {
+                return anyInt();
+            }
+            // Otherwise (like a product) the bounds are at the corners
+            long long corners[4];
+            long long lows[2] = {left.low, left.high};
+            long long highs[2] = {right.low, right.high};
+            for (int i = 0; i < 4; i++) {
+                if (mulNode->isMultiplication) {
+                    corners[i] = lows[i / 2] * highs[i % 2];
+                } else if (highs[i % 2] == 0) {
+                    return anyInt();
+                } else {
+                    corners[i] = lows[i / 2] / highs[i % 2];
+                }
+            }
+            return rangeOf(*std::min_element(corners, corners + 4), *std::max_element(corners, corners + 4));
+        }
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            Range left = analyzeExpr(addNode->left);
+            Range right = analyzeExpr(addNode->right);
+            if (addNode->valueType != ValueType::INT) {
+                return boolean;
+            }
+
+            if (addNode->isAddition) {
+                return rangeOf(left.low + right.low, left.high + right.high);
+            }
+            return rangeOf(left.low - right.high, left.high - right.low);
+        }
+        case NodeKind::UNARY: {
+            auto *unaryNode = static_cast<UnaryNode *>(exprNode);
+            Range operand = analyzeExpr(unaryNode->operand);
+            if (unaryNode->op == UnaryNode::NEG) {
+                return rangeOf(-operand.high, -operand.low);
+            }
+            return boolean;
+        }
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            switch (factorNode->type) {
+                case FactorNode::INT:
+                    return Range{factorNode->intValue, factorNode->intValue};
+                case FactorNode::BOOL:
+                    return Range{factorNode->boolValue, factorNode->boolValue};
+                default:
+                    return analyzeExpr(factorNode->loc);
+            }
+        }
+        // Short circuit: the right operand of && only runs when the left one is true
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            analyzeExpr(andNode->left);
+
+            State skipped = state;
+            refine(andNode->left);
+            analyzeExpr(andNode->right);
+            state = skipped;
+            return boolean;
+        }
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            analyzeExpr(orNode->left);
+            analyzeExpr(orNode->right);
+            return boolean;
+        }
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            analyzeExpr(eqNode->left);
+            analyzeExpr(eqNode->right);
+            return boolean;
+        }
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            analyzeExpr(relNode->left);
+            analyzeExpr(relNode->right);
+            return boolean;
+        }
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+            return idNode->valueType == ValueType::INT ? state.ranges[idNode->slot] : boolean;
+        }
+        // Array access: the check is dropped when every possible index fits the smallest declaration of the array
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            Range index = analyzeExpr(arrayAccessNode->index);
+
+            arrayAccessNode->checkBounds = !(state.reachable && index.low >= 0 && index.high < arraySizes[arrayAccessNode->slot]);
+            return arrayAccessNode->valueType == ValueType::INT ? anyInt() : boolean;
+        }
+        default:
+            return anyInt();
+    }
+}
+
+// Narrows the ranges of the variables compared by a condition known to be true.
+// A condition that cannot hold makes the following code unreachable.
+void RangeAnalysis::refine(Node *condition) {
+    auto narrow = [this](IdNode *idNode, long long low, long long high) {
+        Range &range = state.ranges[idNode->slot];
+        range.low = std::max(range.low, low);
+        range.high = std::min(range.high, high);
+
+        if (range.low > range.high) {
+            state.reachable = false;
+        }
+    };
+
+    switch (condition->kind) {
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(condition);
+            refine(andNode->left);
+            refine(andNode->right);
+            break;
+        }
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(condition);
+            if (!eqNode->isEqual) {
+                break;
+            }
+
+            Range left = analyzeExpr(eqNode->left);
+            Range right = analyzeExpr(eqNode->right);
+            if (IdNode *idNode = variableOf(eqNode->left)) {
+                narrow(idNode, right.low, right.high);
+            }
+            if (IdNode *idNode = variableOf(eqNode->right)) {
+                narrow(idNode, left.low, left.high);
+            }
+            break;
+        }
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(condition);
+            if (relNode->left->valueType != ValueType::INT || relNode->right->valueType != ValueType::INT) {
+                break;
+            }
+
+            Range left = analyzeExpr(relNode->left);
+            Range right = analyzeExpr(relNode->right);
+            IdNode *leftId = variableOf(relNode->left);
+            IdNode *rightId = variableOf(relNode->right);
+
+            switch (relNode->op) {
+                case RelNode::LESS:
+                    if (leftId) {
+                        narrow(leftId, INT_MIN, right.high - 1);
+                    }
+                    if (rightId) {
+                        narrow(rightId, left.low + 1, INT_MAX);
+                    }
+                    break;
+                case RelNode::LESSEQ:
+                    if (leftId) {
+                        narrow(leftId, INT_MIN, right.high);
+                    }
+                    if (rightId) {
+                        narrow(rightId, left.low, INT_MAX);
+                    }
+                    break;
+                case RelNode::GREATER:
+                    if (leftId) {
+                        narrow(leftId, right.low + 1, INT_MAX);
+                    }
+                    if (rightId) {
+                        narrow(rightId, INT_MIN, left.high - 1);
+                    }
+                    break;
+                case RelNode::GREATEREQ:
+                    if (leftId) {
+                        narrow(leftId, right.low, INT_MAX);
+                    }
+                    if (rightId) {
+                        narrow(rightId, INT_MIN, left.high);
+                    }
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
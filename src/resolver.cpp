@@ -0,0 +1,374 @@
+// File created by fob
+
+#include "../include/resolver.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Throws a semantic error with the provided error message specifying line and column
+void Resolver::throwError(const std::string &message, Node *node) {
+    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column);
+    throw std::runtime_error(errMsg);
+}
+
+// Returns the name of a kind of declaration as written in the source
+static std::string kindName(int kind) {
+    return std::string(kind & 1 ? "boolean" : "int") + (kind & 2 ? " array" : "");
+}
+
+// Returns the kind of a declaration: bit 0 is set for a boolean, bit 1 for an array
+int Resolver::kindOf(DeclNode *decl) {
+    Node *typeNode = decl->type;
+    int kind = 0;
+
+    if (auto *arrayType = node_cast<ArrayTypeNode>(typeNode)) {
+        typeNode = arrayType->type;
+        kind = 2;
+    }
+
+    auto *basicType = node_cast<BasicTypeNode>(typeNode);
+    if (!basicType) {
+        throwError("Invalid type node in declaration", decl);
+    }
+
+    return basicType->typeName == "integer" ? kind : kind | 1;
+}
+
+// Adds the declarations of a state to another one
+void Resolver::join(std::vector<uint8_t> &into, const std::vector<uint8_t> &from) {
+    for (size_t i = 0; i < into.size(); i++) {
+        into[i] |= from[i];
+    }
+}
+
+// Returns the slot of a symbol for a kind (or UNDECLARED), allocating a new one the first time it is seen
+int Resolver::slotOf(int symbol, int kind, std::string_view name) {
+    size_t index = (size_t) symbol * (KINDS + 1) + kind;
+    if (index >= slots.size()) {
+        slots.resize(((size_t) symbol + 1) * (KINDS + 1), -1);
+    }
+
+    if (slots[index] < 0) {
+        slots[index] = (int) program->variables.size();
+        program->variables.emplace_back(name);
+    }
+
+    return slots[index];
+}
+
+// Returns the slot a use of a symbol refers to. A symbol declared with a single kind always has the
+// slot of that kind, the other ones take the kind of the declarations reaching the use, or of their
+// first declaration when none does (the use then fails at runtime as the variable is not declared).
+// A use met before the first declaration of its symbol takes the UNDECLARED slot, which becomes the
+// slot of the kind of that declaration.
+int Resolver::useOf(Node *node, int symbol, std::string_view name) {
+    if (symbol >= (int) declared.size() || !declared[symbol]) {
+        return slotOf(symbol, UNDECLARED, name);
+    }
+
+    int kind = firstKind[symbol];
+    if (symbol < (int) tracked.size() && tracked[symbol] >= 0) {
+        uint8_t kinds = reaching[tracked[symbol]];
+
+        if (kinds & (kinds - 1)) {
+            std::string names;
+            for (int other = 0; other < KINDS; other++) {
+                if (kinds >> other & 1) {
+                    names += (names.empty() ? "" : " or ") + kindName(other);
+                }
+            }
+            throwError("Variable " + std::string(name) + " may be declared as " + names + " here", node);
+        }
+
+        for (int other = 0; other < KINDS; other++) {
+            if (kinds >> other & 1) {
+                kind = other;
+            }
+        }
+    }
+
+    return slotOf(symbol, kind, name);
+}
+
+// Resolves the root program node
+void Resolver::resolve(Node *node) {
+    program = node_cast<ProgramNode>(node);
+    if (!program) {
+        throwError("Program should start with a ProgramNode", node);
+    }
+
+    declared.clear();
+    firstKind.clear();
+    tracked.clear();
+    reaching.clear();
+
+    // The first pass gives each symbol the slot of the kind of its first declaration and records
+    // the kinds it is declared with
+    resolvePass();
+
+    // Only the symbols declared with several kinds need a second pass, following the declarations
+    // reaching their uses
+    int count = 0;
+    tracked.assign(declared.size(), -1);
+    for (size_t symbol = 0; symbol < declared.size(); symbol++) {
+        if (declared[symbol] & (declared[symbol] - 1)) {
+            tracked[symbol] = count++;
+        }
+    }
+
+    if (count > 0) {
+        reaching.assign(count, 0);
+        resolvePass();
+    }
+}
+
+// Resolves the whole program, allocating the slots again
+void Resolver::resolvePass() {
+    program->variables.clear();
+    slots.clear();
+    breaks.clear();
+
+    resolveBlock(program->block);
+}
+
+// Resolves a block node
+void Resolver::resolveBlock(Node *blockNode) {
+    if (auto *block = node_cast<BlockNode>(blockNode)) {
+        if (Node *decls = block->decls) {
+            resolveDecls(decls);
+        }
+        if (Node *stmts = block->stmts) {
+            resolveStmts(stmts);
+        }
+    } else {
+        throwError("Invalid block node", blockNode);
+    }
+}
+
+// Resolves a sequence of declarations
+void Resolver::resolveDecls(Node *declsNode) {
+    auto *decls = node_cast<DeclsNode>(declsNode);
+    if (!decls) {
+        throwError("Invalid declarations node", declsNode);
+    }
+
+    // A declaration replaces the variable of its name from then on
+    for (Node *declNode : *decls) {
+        auto *decl = node_cast<DeclNode>(declNode);
+        if (!decl) {
+            throwError("Invalid declaration node", declNode);
+        }
+
+        int symbol = decl->symbol;
+        int kind = kindOf(decl);
+
+        if (symbol >= (int) declared.size()) {
+            declared.resize(symbol + 1, 0);
+            firstKind.resize(symbol + 1, 0);
+        }
+        if (!declared[symbol]) {
+            // The uses met so far refer to this declaration
+            firstKind[symbol] = (uint8_t) kind;
+            int undeclared = slotOf(symbol, UNDECLARED, decl->id);
+            slots[(size_t) symbol * (KINDS + 1) + kind] = undeclared;
+        }
+        declared[symbol] |= (uint8_t) (1 << kind);
+
+        decl->slot = slotOf(symbol, kind, decl->id);
+        if (symbol < (int) tracked.size() && tracked[symbol] >= 0) {
+            reaching[tracked[symbol]] = (uint8_t) (1 << kind);
+        }
+    }
+}
+
+// Resolves a sequence of statements
+void Resolver::resolveStmts(Node *stmtsNode) {
+    auto *stmts = node_cast<StmtsNode>(stmtsNode);
+    if (!stmts) {
+        throwError("Invalid statements node", stmtsNode);
+    }
+
+    for (Node *stmt : *stmts) {
+        resolveStmt(stmt);
+    }
+}
+
+// Resolves a single statement
+void Resolver::resolveStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            resolveExpr(assign->loc);
+            resolveExpr(assign->expr);
+            break;
+        }
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            resolveExpr(ifStmt->condition);
+
+            if (reaching.empty()) {
+                resolveStmt(ifStmt->ifStmt);
+                break;
+            }
+
+            std::vector<uint8_t> skipped = reaching;
+            resolveStmt(ifStmt->ifStmt);
+            join(reaching, skipped);
+            break;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            resolveExpr(ifElseStmt->condition);
+
+            if (reaching.empty()) {
+                resolveStmt(ifElseStmt->ifStmt);
+                resolveStmt(ifElseStmt->elseStmt);
+                break;
+            }
+
+            std::vector<uint8_t> branch = reaching;
+            resolveStmt(ifElseStmt->ifStmt);
+            std::swap(branch, reaching);
+            resolveStmt(ifElseStmt->elseStmt);
+            join(reaching, branch);
+            break;
+        }
+        case NodeKind::WHILE:
+        case NodeKind::DO_WHILE:
+            resolveLoop(stmtNode);
+            break;
+        case NodeKind::PRINT:
+            resolveExpr(static_cast<PrintNode *>(stmtNode)->expr);
+            break;
+        case NodeKind::BREAK:
+            // The declarations go on after the loop, nothing reaches the statements after the break
+            if (!breaks.empty() && !reaching.empty()) {
+                join(breaks.back(), reaching);
+                std::fill(reaching.begin(), reaching.end(), 0);
+            }
+            break;
+        case NodeKind::BLOCK:
+            resolveBlock(stmtNode);
+            break;
+        default:
+            throwError("Unknown statement type", stmtNode);
+    }
+}
+
+// Resolves a loop. An iteration starts with the declarations reaching the loop or the end of the previous
+// iteration, so the body is resolved again until they stop growing: as they only gain kinds, this ends
+// after a few rounds, and a single one when the body declares no symbol with several kinds.
+void Resolver::resolveLoop(Node *loopNode) {
+    auto *whileStmt = node_cast<WhileNode>(loopNode);
+    auto *doWhileStmt = node_cast<DoWhileNode>(loopNode);
+    Node *condition = whileStmt ? whileStmt->condition : doWhileStmt->condition;
+    Node *body = whileStmt ? whileStmt->body : doWhileStmt->body;
+
+    // Without symbols declared with several kinds there is nothing to track
+    if (reaching.empty()) {
+        if (whileStmt) {
+            resolveExpr(condition);
+        }
+        resolveStmt(body);
+        if (doWhileStmt) {
+            resolveExpr(condition);
+        }
+        return;
+    }
+
+    std::vector<uint8_t> entry = reaching;
+
+    for (;;) {
+        std::vector<uint8_t> start = reaching;
+
+        if (whileStmt) {
+            resolveExpr(condition);
+        }
+        breaks.emplace_back(reaching.size(), 0);
+        resolveStmt(body);
+        if (doWhileStmt) {
+            resolveExpr(condition);
+        }
+
+        std::vector<uint8_t> exits = std::move(breaks.back());
+        breaks.pop_back();
+
+        std::vector<uint8_t> next = reaching;
+        join(next, entry);
+        if (next == start) {
+            // A while loop ends on its condition before an iteration, a do-while loop after one
+            if (whileStmt) {
+                reaching = std::move(start);
+            }
+            join(reaching, exits);
+            return;
+        }
+
+        reaching = std::move(next);
+    }
+}
+
+// Resolves an expression
+void Resolver::resolveExpr(Node *exprNode) {
+    switch (exprNode->kind) {
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            resolveExpr(mulNode->left);
+            resolveExpr(mulNode->right);
+            break;
+        }
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            resolveExpr(addNode->left);
+            resolveExpr(addNode->right);
+            break;
+        }
+        case NodeKind::UNARY:
+            resolveExpr(static_cast<UnaryNode *>(exprNode)->operand);
+            break;
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            if (factorNode->type == FactorNode::ID) {
+                resolveExpr(factorNode->loc);
+            }
+            break;
+        }
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            resolveExpr(orNode->left);
+            resolveExpr(orNode->right);
+            break;
+        }
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            resolveExpr(andNode->left);
+            resolveExpr(andNode->right);
+            break;
+        }
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            resolveExpr(eqNode->left);
+            resolveExpr(eqNode->right);
+            break;
+        }
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            resolveExpr(relNode->left);
+            resolveExpr(relNode->right);
+            break;
+        }
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+            idNode->slot = useOf(idNode, idNode->symbol, idNode->id);
+            break;
+        }
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            arrayAccessNode->slot = useOf(arrayAccessNode, arrayAccessNode->symbol, arrayAccessNode->id);
+            resolveExpr(arrayAccessNode->index);
+            break;
+        }
+        default:
+            throwError("Node resolution not implemented yet", exprNode);
+    }
+}
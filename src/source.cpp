@@ -0,0 +1,79 @@
+// File created by fob
+
+#include "../include/source.h"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IEC_HAS_MMAP 1
+#else
+#include <filesystem>
+#endif
+
+// Constructor: maps the file, reads it into the buffer when it cannot be mapped
+SourceFile::SourceFile(const std::string &path) {
+#ifdef IEC_HAS_MMAP
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+
+    // Directories, pipes and devices are not source files
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+
+    if (info.st_size > 0) {
+        void *mapping = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED) {
+            madvise(mapping, (size_t) info.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(mapping);
+            size = (size_t) info.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+
+    if (mapped) {
+        return;
+    }
+#else
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+#endif
+
+    // Fallback: read the whole file into memory (empty files, or no mapping available)
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Unable to open file " + path);
+    }
+
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+}
+
+// Destructor: releases the mapping
+SourceFile::~SourceFile() {
+#ifdef IEC_HAS_MMAP
+    if (mapped) {
+        munmap(const_cast<char *>(data), size);
+    }
+#endif
+}
+
+// Returns the content of the file
+std::string_view SourceFile::text() const {
+    return std::string_view(data, size);
+}
@@ -0,0 +1,250 @@
+// File created by fob
+
+#include "../include/typechecker.h"
+
+#include <stdexcept>
+
+// Throws a type error with the provided error message specifying line and column
+void TypeChecker::throwError(const std::string &message, Node *node) {
+    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column);
+    throw std::runtime_error(errMsg);
+}
+
+// Checks the root program node
+void TypeChecker::check(Node *node) {
+    auto *program = node_cast<ProgramNode>(node);
+    if (!program) {
+        throwError("Program should start with a ProgramNode", node);
+    }
+
+    slots.assign(program->variables.size(), SlotType());
+
+    collectDecls(program->block);
+    checkBlock(program->block);
+}
+
+// Records the declarations found in a block and in its nested statements.
+// The Resolver gives each base type and shape of a name its own slot, so the declarations of a slot agree.
+void TypeChecker::collectDecls(Node *node) {
+    switch (node->kind) {
+        case NodeKind::BLOCK: {
+            auto *block = static_cast<BlockNode *>(node);
+
+            if (auto *decls = node_cast<DeclsNode>(block->decls)) {
+                for (Node *declNode : *decls) {
+                    auto *decl = static_cast<DeclNode *>(declNode);
+                    Node *typeNode = decl->type;
+                    bool isArray = false;
+
+                    if (auto *arrayType = node_cast<ArrayTypeNode>(typeNode)) {
+                        typeNode = arrayType->type;
+                        isArray = true;
+                    }
+
+                    auto *basicType = node_cast<BasicTypeNode>(typeNode);
+                    if (!basicType) {
+                        throwError("Invalid type node in declaration", decl);
+                    }
+
+                    ValueType type = basicType->typeName == "integer" ? ValueType::INT : ValueType::BOOL;
+                    SlotType &slot = slots[decl->slot];
+
+                    if (!slot.decl) {
+                        slot = {type, isArray, decl};
+                    }
+                }
+            }
+
+            if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+                for (Node *stmt : *stmts) {
+                    collectDecls(stmt);
+                }
+            }
+            break;
+        }
+        case NodeKind::IF:
+            collectDecls(static_cast<IfNode *>(node)->ifStmt);
+            break;
+        case NodeKind::IF_ELSE:
+            collectDecls(static_cast<IfElseNode *>(node)->ifStmt);
+            collectDecls(static_cast<IfElseNode *>(node)->elseStmt);
+            break;
+        case NodeKind::WHILE:
+            collectDecls(static_cast<WhileNode *>(node)->body);
+            break;
+        case NodeKind::DO_WHILE:
+            collectDecls(static_cast<DoWhileNode *>(node)->body);
+            break;
+        default:
+            break;
+    }
+}
+
+// Checks the statements of a block
+void TypeChecker::checkBlock(Node *blockNode) {
+    auto *block = node_cast<BlockNode>(blockNode);
+    if (!block) {
+        throwError("Invalid block node", blockNode);
+    }
+
+    if (auto *stmts = node_cast<StmtsNode>(block->stmts)) {
+        for (Node *stmt : *stmts) {
+            checkStmt(stmt);
+        }
+    }
+}
+
+// Checks a single statement.
+// Conditions and printed values may have any type, as the interpreter always accepted them.
+void TypeChecker::checkStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        // Assign: the value must have the type of the variable
+        case NodeKind::ASSIGN: {
+            auto *assign = static_cast<AssignNode *>(stmtNode);
+            ValueType locType = checkExpr(assign->loc);
+
+            if (checkExpr(assign->expr) != locType) {
+                throwError("Value mismatch", assign->loc);
+            }
+            break;
+        }
+        case NodeKind::IF: {
+            auto *ifStmt = static_cast<IfNode *>(stmtNode);
+            checkExpr(ifStmt->condition);
+            checkStmt(ifStmt->ifStmt);
+            break;
+        }
+        case NodeKind::IF_ELSE: {
+            auto *ifElseStmt = static_cast<IfElseNode *>(stmtNode);
+            checkExpr(ifElseStmt->condition);
+            checkStmt(ifElseStmt->ifStmt);
+            checkStmt(ifElseStmt->elseStmt);
+            break;
+        }
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+            checkExpr(whileStmt->condition);
+            checkStmt(whileStmt->body);
+            break;
+        }
+        case NodeKind::DO_WHILE: {
+            auto *doWhileStmt = static_cast<DoWhileNode *>(stmtNode);
+            checkStmt(doWhileStmt->body);
+            checkExpr(doWhileStmt->condition);
+            break;
+        }
+        case NodeKind::PRINT:
+            checkExpr(static_cast<PrintNode *>(stmtNode)->expr);
+            break;
+        case NodeKind::BREAK:
+            break;
+        case NodeKind::BLOCK:
+            checkBlock(stmtNode);
+            break;
+        default:
+            throwError("Unknown statement type", stmtNode);
+    }
+}
+
+// Checks an expression, stores its type in the node and returns it
+ValueType TypeChecker::checkExpr(Node *exprNode) {
+    ValueType type = ValueType::UNKNOWN;
+
+    switch (exprNode->kind) {
+        // Arithmetic: both operands must have the same type (booleans have their own arithmetic)
+        case NodeKind::MUL: {
+            auto *mulNode = static_cast<MulNode *>(exprNode);
+            type = checkExpr(mulNode->left);
+            if (checkExpr(mulNode->right) != type) {
+                throwError("Value type mismatch", mulNode);
+            }
+            break;
+        }
+        case NodeKind::ADD: {
+            auto *addNode = static_cast<AddNode *>(exprNode);
+            type = checkExpr(addNode->left);
+            if (checkExpr(addNode->right) != type) {
+                throwError("Value type mismatch", addNode);
+            }
+            break;
+        }
+        // Unary operation: ! needs a boolean, - an integer
+        case NodeKind::UNARY: {
+            auto *unaryNode = static_cast<UnaryNode *>(exprNode);
+            type = unaryNode->op == UnaryNode::NOT ? ValueType::BOOL : ValueType::INT;
+            if (checkExpr(unaryNode->operand) != type) {
+                throwError("Mismatched unary operation type", unaryNode);
+            }
+            break;
+        }
+        // Factor
+        case NodeKind::FACTOR: {
+            auto *factorNode = static_cast<FactorNode *>(exprNode);
+            type = factorNode->type == FactorNode::ID ? checkExpr(factorNode->loc) : factorNode->valueType;
+            break;
+        }
+        // Logical operations convert their operands to booleans
+        case NodeKind::OR: {
+            auto *orNode = static_cast<OrNode *>(exprNode);
+            checkExpr(orNode->left);
+            checkExpr(orNode->right);
+            type = ValueType::BOOL;
+            break;
+        }
+        case NodeKind::AND: {
+            auto *andNode = static_cast<AndNode *>(exprNode);
+            checkExpr(andNode->left);
+            checkExpr(andNode->right);
+            type = ValueType::BOOL;
+            break;
+        }
+        // Equality: both operands must have the same type
+        case NodeKind::EQUALITY: {
+            auto *eqNode = static_cast<EqualityNode *>(exprNode);
+            if (checkExpr(eqNode->left) != checkExpr(eqNode->right)) {
+                throwError("Value type mismatch", eqNode);
+            }
+            type = ValueType::BOOL;
+            break;
+        }
+        // Relation: operands are compared by value, whatever their type
+        case NodeKind::REL: {
+            auto *relNode = static_cast<RelNode *>(exprNode);
+            checkExpr(relNode->left);
+            checkExpr(relNode->right);
+            type = ValueType::BOOL;
+            break;
+        }
+        // Id
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(exprNode);
+            type = checkVariable(idNode, idNode->slot, idNode->id, false).type;
+            break;
+        }
+        // Array access: the index may have any type
+        case NodeKind::ARRAY_ACCESS: {
+            auto *arrayAccessNode = static_cast<ArrayAccessNode *>(exprNode);
+            checkExpr(arrayAccessNode->index);
+            type = checkVariable(arrayAccessNode, arrayAccessNode->slot, arrayAccessNode->id, true).type;
+            break;
+        }
+        default:
+            throwError("Unknown expression type", exprNode);
+    }
+
+    exprNode->valueType = type;
+    return type;
+}
+
+// Checks that a variable is declared somewhere with the shape used by the access
+const TypeChecker::SlotType &TypeChecker::checkVariable(Node *node, int slot, std::string_view id, bool isArray) {
+    const SlotType &slotType = slots[slot];
+
+    if (!slotType.decl) {
+        throwError("Variable " + std::string(id) + " is never declared", node);
+    } else if (slotType.isArray != isArray) {
+        throwError("Variable " + std::string(id) + (isArray ? " is not an array" : " is an array"), node);
+    }
+
+    return slotType;
+}
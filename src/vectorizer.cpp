@@ -0,0 +1,318 @@
+// File created by fob
+
+#include "../include/vectorizer.h"
+
+#include <algorithm>
+
+// Adds a slot to a list unless it is already there
+static void addSlot(std::vector<int> &slots, int slot) {
+    if (std::find(slots.begin(), slots.end(), slot) == slots.end()) {
+        slots.push_back(slot);
+    }
+}
+
+// Checks if a list holds a slot
+static bool hasSlot(const std::vector<int> &slots, int slot) {
+    return std::find(slots.begin(), slots.end(), slot) != slots.end();
+}
+
+// Constructor: kernels are allocated in the arena owning the AST
+Vectorizer::Vectorizer(Arena &arena) : arena(arena) {}
+
+// Vectorizes the loops of the root program node
+void Vectorizer::vectorize(Node *node) {
+    if (auto *program = node_cast<ProgramNode>(node)) {
+        vectorizeStmt(program->block);
+    }
+}
+
+// Walks the statements, a loop that is not vectorized may still hold vectorizable loops
+void Vectorizer::vectorizeStmt(Node *stmtNode) {
+    switch (stmtNode->kind) {
+        case NodeKind::IF:
+            vectorizeStmt(static_cast<IfNode *>(stmtNode)->ifStmt);
+            break;
+        case NodeKind::IF_ELSE:
+            vectorizeStmt(static_cast<IfElseNode *>(stmtNode)->ifStmt);
+            vectorizeStmt(static_cast<IfElseNode *>(stmtNode)->elseStmt);
+            break;
+        case NodeKind::BLOCK:
+            if (auto *stmts = node_cast<StmtsNode>(static_cast<BlockNode *>(stmtNode)->stmts)) {
+                for (Node *stmt : *stmts) {
+                    vectorizeStmt(stmt);
+                }
+            }
+            break;
+        case NodeKind::WHILE: {
+            auto *whileStmt = static_cast<WhileNode *>(stmtNode);
+
+            if (buildLoop(whileStmt)) {
+                whileStmt->vector = arena.make<VectorLoop>(loop);
+            } else {
+                vectorizeStmt(whileStmt->body);
+            }
+            break;
+        }
+        case NodeKind::DO_WHILE:
+            vectorizeStmt(static_cast<DoWhileNode *>(stmtNode)->body);
+            break;
+        default:
+            break;
+    }
+}
+
+// Matches while (i < n) { ...; i = i + 1; } and builds the operations of the other statements
+bool Vectorizer::buildLoop(WhileNode *whileNode) {
+    auto *condition = node_cast<RelNode>(whileNode->condition);
+    if (!condition || (condition->op != RelNode::LESS && condition->op != RelNode::LESSEQ)) {
+        return false;
+    }
+
+    IdNode *counter = provenVariable(condition->left);
+    if (!counter) {
+        return false;
+    }
+
+    loop = VectorLoop();
+    loop.counter = counter->slot;
+    loop.inclusive = condition->op == RelNode::LESSEQ;
+
+    if (IdNode *bound = provenVariable(condition->right)) {
+        loop.bound = bound->slot;
+    } else if (!literalValue(condition->right, loop.boundValue)) {
+        return false;
+    }
+
+    auto *block = node_cast<BlockNode>(whileNode->body);
+    if (!block || (block->decls && static_cast<DeclsNode *>(block->decls)->count > 0)) {
+        return false;
+    }
+
+    auto *stmts = node_cast<StmtsNode>(block->stmts);
+    if (!stmts || stmts->count < 2) {
+        return false;
+    }
+
+    // The last statement steps i by one
+    auto *increment = node_cast<AssignNode>(stmts->stmts[stmts->count - 1]);
+    auto *step = increment ? node_cast<AddNode>(increment->expr) : nullptr;
+    auto *target = increment ? node_cast<IdNode>(increment->loc) : nullptr;
+    int one = 0;
+
+    if (!step || !step->isAddition || !target || target->checked || target->slot != loop.counter
+        || !((isCounter(step->left) && literalValue(step->right, one)) || (literalValue(step->left, one) && isCounter(step->right)))
+        || one != 1) {
+        return false;
+    }
+
+    // Variables written by the iterations: they are never read as invariant operands.
+    // Only the last statement steps i, any other assignment to it changes the iterations run.
+    written.assign(1, loop.counter);
+    for (size_t i = 0; i + 1 < stmts->count; i++) {
+        auto *assign = node_cast<AssignNode>(stmts->stmts[i]);
+        if (!assign) {
+            return false;
+        }
+        if (auto *idNode = node_cast<IdNode>(assign->loc)) {
+            if (idNode->slot == loop.counter) {
+                return false;
+            }
+            written.push_back(idNode->slot);
+        }
+    }
+
+    if (loop.bound >= 0 && hasSlot(written, loop.bound)) {
+        return false;
+    }
+
+    stored.clear();
+    for (size_t i = 0; i + 1 < stmts->count; i++) {
+        if (!buildStmt(stmts->stmts[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Adds the operations of an element store or of a reduction
+bool Vectorizer::buildStmt(Node *stmtNode) {
+    auto *assign = static_cast<AssignNode *>(stmtNode);
+
+    // Element store: a[i] = e (integer array) or b[i] = x op y (boolean array)
+    if (auto *access = node_cast<ArrayAccessNode>(assign->loc)) {
+        if (!isCounter(access->index)) {
+            return false;
+        }
+
+        if (assign->expr->valueType == ValueType::INT) {
+            int value = buildExpr(assign->expr);
+            if (value < 0 || hasSlot(loop.boolArrays, access->slot)) {
+                return false;
+            }
+
+            // A computed value is written straight into the array instead of being copied there
+            VectorLoop::Op last = loop.code.back().op;
+            bool computed = loop.code.back().a == value && last >= VectorLoop::Op::ADD && last <= VectorLoop::Op::MUL;
+
+            loop.code.push_back({VectorLoop::Op::STORE, access->slot, value, computed ? 1 : 0});
+            addSlot(loop.intArrays, access->slot);
+        } else if (auto *literal = node_cast<FactorNode>(assign->expr); literal && literal->type == FactorNode::BOOL) {
+            int value = emit(VectorLoop::Op::CONSTANT, literal->boolValue);
+            if (value < 0 || hasSlot(loop.intArrays, access->slot)) {
+                return false;
+            }
+
+            loop.code.push_back({VectorLoop::Op::STORE_BOOL, access->slot, value, 0});
+            addSlot(loop.boolArrays, access->slot);
+        } else {
+            VectorLoop::Op op;
+            Node *left;
+            Node *right;
+
+            if (auto *equality = node_cast<EqualityNode>(assign->expr)) {
+                op = equality->isEqual ? VectorLoop::Op::EQ : VectorLoop::Op::NEQ;
+                left = equality->left;
+                right = equality->right;
+            } else if (auto *rel = node_cast<RelNode>(assign->expr)) {
+                switch (rel->op) {
+                    case RelNode::LESS: op = VectorLoop::Op::LESS; break;
+                    case RelNode::LESSEQ: op = VectorLoop::Op::LESSEQ; break;
+                    case RelNode::GREATER: op = VectorLoop::Op::GREATER; break;
+                    case RelNode::GREATEREQ: op = VectorLoop::Op::GREATEREQ; break;
+                    default: return false;
+                }
+                left = rel->left;
+                right = rel->right;
+            } else {
+                return false;
+            }
+
+            int leftValue = buildExpr(left);
+            int rightValue = leftValue < 0 ? -1 : buildExpr(right);
+            int value = rightValue < 0 ? -1 : emit(op, leftValue, rightValue);
+            if (value < 0 || hasSlot(loop.intArrays, access->slot)) {
+                return false;
+            }
+
+            loop.code.push_back({VectorLoop::Op::STORE_BOOL, access->slot, value, 0});
+            addSlot(loop.boolArrays, access->slot);
+        }
+
+        addSlot(stored, access->slot);
+        return true;
+    }
+
+    // Reduction: s = s + e, s = e + s or s = s - e
+    auto *idNode = node_cast<IdNode>(assign->loc);
+    auto *addNode = node_cast<AddNode>(assign->expr);
+    if (!idNode || idNode->checked || idNode->slot == loop.counter || !addNode || addNode->valueType != ValueType::INT) {
+        return false;
+    }
+
+    IdNode *left = provenVariable(addNode->left);
+    IdNode *right = provenVariable(addNode->right);
+    Node *operand;
+
+    if (left && left->slot == idNode->slot) {
+        operand = addNode->right;
+    } else if (addNode->isAddition && right && right->slot == idNode->slot) {
+        operand = addNode->left;
+    } else {
+        return false;
+    }
+
+    int value = buildExpr(operand);
+    if (value < 0) {
+        return false;
+    }
+
+    loop.code.push_back({VectorLoop::Op::SUM, idNode->slot, value, addNode->isAddition ? 0 : 1});
+    return true;
+}
+
+// Adds the operations of an integer expression, operands first
+int Vectorizer::buildExpr(Node *exprNode) {
+    if (exprNode->valueType != ValueType::INT) {
+        return -1;
+    }
+
+    Node *node = unwrap(exprNode);
+    int value;
+
+    switch (node->kind) {
+        case NodeKind::FACTOR:
+            return literalValue(node, value) ? emit(VectorLoop::Op::CONSTANT, value) : -1;
+        case NodeKind::ID: {
+            auto *idNode = static_cast<IdNode *>(node);
+            if (idNode->checked) {
+                return -1;
+            }
+            if (idNode->slot == loop.counter) {
+                return emit(VectorLoop::Op::COUNTER);
+            }
+            return hasSlot(written, idNode->slot) ? -1 : emit(VectorLoop::Op::SCALAR, idNode->slot);
+        }
+        case NodeKind::ARRAY_ACCESS: {
+            auto *access = static_cast<ArrayAccessNode *>(node);
+            if (!isCounter(access->index) || hasSlot(loop.boolArrays, access->slot)) {
+                return -1;
+            }
+
+            // The elements stored earlier in the iteration are initialized by then
+            if (!hasSlot(stored, access->slot)) {
+                addSlot(loop.reads, access->slot);
+            }
+            addSlot(loop.intArrays, access->slot);
+
+            return emit(VectorLoop::Op::ELEMENT, access->slot);
+        }
+        case NodeKind::ADD:
+        case NodeKind::MUL: {
+            auto *addNode = node_cast<AddNode>(node);
+            auto *mulNode = node_cast<MulNode>(node);
+            if (mulNode && !mulNode->isMultiplication) {
+                return -1;
+            }
+
+            VectorLoop::Op op = mulNode ? VectorLoop::Op::MUL : addNode->isAddition ? VectorLoop::Op::ADD : VectorLoop::Op::SUB;
+            int left = buildExpr(addNode ? addNode->left : mulNode->left);
+            int right = left < 0 ? -1 : buildExpr(addNode ? addNode->right : mulNode->right);
+
+            return right < 0 ? -1 : emit(op, left, right);
+        }
+        case NodeKind::UNARY: {
+            // -x is computed as 0 - x
+            auto *unaryNode = static_cast<UnaryNode *>(node);
+            if (unaryNode->op != UnaryNode::NEG) {
+                return -1;
+            }
+
+            int zero = emit(VectorLoop::Op::CONSTANT, 0);
+            int operand = zero < 0 ? -1 : buildExpr(unaryNode->operand);
+
+            return operand < 0 ? -1 : emit(VectorLoop::Op::SUB, zero, operand);
+        }
+        default:
+            return -1;
+    }
+}
+
+// Appends an operation writing a new temporary, -1 when the kernel has no temporary left
+int Vectorizer::emit(VectorLoop::Op op, int b, int c) {
+    if (loop.temporaries == VectorLoop::MAX_TEMPORARIES) {
+        return -1;
+    }
+
+    int temporary = loop.temporaries++;
+    loop.code.push_back({op, temporary, b, c});
+
+    return temporary;
+}
+
+// Checks if an expression is a proven read of i
+bool Vectorizer::isCounter(Node *node) const {
+    IdNode *idNode = provenVariable(node);
+
+    return idNode && idNode->slot == loop.counter;
+}
@@ -0,0 +1,403 @@
+// File created by fob
+
+#include "../include/vectorloop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define IEC_HAS_SIMD 1
+#endif
+
+// Operations of the kernels. The scalar form wraps on overflow as the other engines do, the SIMD
+// forms return comparisons as 0 or 1 from the all ones masks of the CPU (a mask + 1 negates it).
+struct AddOp {
+    static int32_t scalar(int32_t x, int32_t y) { return wrapAdd(x, y); }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+#endif
+};
+
+struct SubOp {
+    static int32_t scalar(int32_t x, int32_t y) { return wrapSub(x, y); }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_sub_epi32(x, y); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_sub_epi32(x, y); }
+#endif
+};
+
+struct MulOp {
+    static int32_t scalar(int32_t x, int32_t y) { return wrapMul(x, y); }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_mullo_epi32(x, y); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_mullo_epi32(x, y); }
+#endif
+};
+
+struct EqOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x == y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_srli_epi32(_mm_cmpeq_epi32(x, y), 31); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_srli_epi32(_mm256_cmpeq_epi32(x, y), 31); }
+#endif
+};
+
+struct NeqOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x != y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_add_epi32(_mm_cmpeq_epi32(x, y), _mm_set1_epi32(1)); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_add_epi32(_mm256_cmpeq_epi32(x, y), _mm256_set1_epi32(1)); }
+#endif
+};
+
+struct LessOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x < y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_srli_epi32(_mm_cmpgt_epi32(y, x), 31); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_srli_epi32(_mm256_cmpgt_epi32(y, x), 31); }
+#endif
+};
+
+struct LessEqOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x <= y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_add_epi32(_mm_cmpgt_epi32(x, y), _mm_set1_epi32(1)); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_add_epi32(_mm256_cmpgt_epi32(x, y), _mm256_set1_epi32(1)); }
+#endif
+};
+
+struct GreaterOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x > y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_srli_epi32(_mm_cmpgt_epi32(x, y), 31); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_srli_epi32(_mm256_cmpgt_epi32(x, y), 31); }
+#endif
+};
+
+struct GreaterEqOp {
+    static int32_t scalar(int32_t x, int32_t y) { return x >= y; }
+#ifdef IEC_HAS_SIMD
+    __attribute__((target("sse4.1"))) static __m128i sse(__m128i x, __m128i y) { return _mm_add_epi32(_mm_cmpgt_epi32(y, x), _mm_set1_epi32(1)); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i x, __m256i y) { return _mm256_add_epi32(_mm256_cmpgt_epi32(y, x), _mm256_set1_epi32(1)); }
+#endif
+};
+
+// Applies an operation to count pairs of elements
+template <typename Operation>
+static void binaryScalar(const int32_t *left, const int32_t *right, int32_t *out, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = Operation::scalar(left[i], right[i]);
+    }
+}
+
+// Adds count elements, wrapping on overflow
+static uint32_t sumScalar(const int32_t *elements, int count) {
+    uint32_t sum = 0;
+
+    for (int i = 0; i < count; i++) {
+        sum += (uint32_t) elements[i];
+    }
+    return sum;
+}
+
+// Packs 64 elements holding 0 or 1 into the bits of a word
+static uint64_t packScalar(const int32_t *elements) {
+    uint64_t word = 0;
+
+    for (int i = 0; i < 64; i++) {
+        word |= uint64_t(elements[i] != 0) << i;
+    }
+    return word;
+}
+
+#ifdef IEC_HAS_SIMD
+// SSE4.1 forms, four elements at a time (the remainder of a strip is left to the scalar form)
+template <typename Operation>
+__attribute__((target("sse4.1"))) static void binarySSE(const int32_t *left, const int32_t *right, int32_t *out, int count) {
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *) (left + i));
+        __m128i y = _mm_loadu_si128((const __m128i *) (right + i));
+        _mm_storeu_si128((__m128i *) (out + i), Operation::sse(x, y));
+    }
+    binaryScalar<Operation>(left + i, right + i, out + i, count - i);
+}
+
+__attribute__((target("sse4.1"))) static uint32_t sumSSE(const int32_t *elements, int count) {
+    __m128i sums = _mm_setzero_si128();
+    uint32_t lanes[4];
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        sums = _mm_add_epi32(sums, _mm_loadu_si128((const __m128i *) (elements + i)));
+    }
+    _mm_storeu_si128((__m128i *) lanes, sums);
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(elements + i, count - i);
+}
+
+__attribute__((target("sse4.1"))) static uint64_t packSSE(const int32_t *elements) {
+    uint64_t word = 0;
+
+    for (int i = 0; i < 64; i += 4) {
+        __m128i bits = _mm_slli_epi32(_mm_loadu_si128((const __m128i *) (elements + i)), 31);
+        word |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(bits))) << i;
+    }
+    return word;
+}
+
+// AVX2 forms, eight elements at a time
+template <typename Operation>
+__attribute__((target("avx2"))) static void binaryAVX2(const int32_t *left, const int32_t *right, int32_t *out, int count) {
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *) (left + i));
+        __m256i y = _mm256_loadu_si256((const __m256i *) (right + i));
+        _mm256_storeu_si256((__m256i *) (out + i), Operation::avx2(x, y));
+    }
+    binaryScalar<Operation>(left + i, right + i, out + i, count - i);
+}
+
+__attribute__((target("avx2"))) static uint32_t sumAVX2(const int32_t *elements, int count) {
+    __m256i sums = _mm256_setzero_si256();
+    uint32_t lanes[8];
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        sums = _mm256_add_epi32(sums, _mm256_loadu_si256((const __m256i *) (elements + i)));
+    }
+    _mm256_storeu_si256((__m256i *) lanes, sums);
+
+    uint32_t sum = sumScalar(elements + i, count - i);
+    for (uint32_t lane : lanes) {
+        sum += lane;
+    }
+    return sum;
+}
+
+__attribute__((target("avx2"))) static uint64_t packAVX2(const int32_t *elements) {
+    uint64_t word = 0;
+
+    for (int i = 0; i < 64; i += 8) {
+        __m256i bits = _mm256_slli_epi32(_mm256_loadu_si256((const __m256i *) (elements + i)), 31);
+        word |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(bits))) << i;
+    }
+    return word;
+}
+#endif
+
+// Kernels of an instruction set, the binary ones are indexed from Op::ADD to Op::GREATEREQ
+struct Kernels {
+    const char *name;   // Name of the instruction set
+    void (*binary[9])(const int32_t *left, const int32_t *right, int32_t *out, int count);
+    uint32_t (*sum)(const int32_t *elements, int count);
+    uint64_t (*pack)(const int32_t *elements);
+};
+
+static const Kernels SCALAR_KERNELS = {"scalar", {
+    binaryScalar<AddOp>, binaryScalar<SubOp>, binaryScalar<MulOp>, binaryScalar<EqOp>, binaryScalar<NeqOp>,
+    binaryScalar<LessOp>, binaryScalar<LessEqOp>, binaryScalar<GreaterOp>, binaryScalar<GreaterEqOp>
+}, sumScalar, packScalar};
+
+#ifdef IEC_HAS_SIMD
+static const Kernels SSE_KERNELS = {"sse4.1", {
+    binarySSE<AddOp>, binarySSE<SubOp>, binarySSE<MulOp>, binarySSE<EqOp>, binarySSE<NeqOp>,
+    binarySSE<LessOp>, binarySSE<LessEqOp>, binarySSE<GreaterOp>, binarySSE<GreaterEqOp>
+}, sumSSE, packSSE};
+
+static const Kernels AVX2_KERNELS = {"avx2", {
+    binaryAVX2<AddOp>, binaryAVX2<SubOp>, binaryAVX2<MulOp>, binaryAVX2<EqOp>, binaryAVX2<NeqOp>,
+    binaryAVX2<LessOp>, binaryAVX2<LessEqOp>, binaryAVX2<GreaterOp>, binaryAVX2<GreaterEqOp>
+}, sumAVX2, packAVX2};
+#endif
+
+// Returns the kernels of an instruction set if this CPU supports it, nullptr otherwise
+static const Kernels *findKernels(const std::string &name) {
+#ifdef IEC_HAS_SIMD
+    __builtin_cpu_init();
+
+    if ((name == "auto" || name == "avx2") && __builtin_cpu_supports("avx2")) {
+        return &AVX2_KERNELS;
+    }
+    if ((name == "auto" || name == "sse4.1") && __builtin_cpu_supports("sse4.1")) {
+        return &SSE_KERNELS;
+    }
+#endif
+    return name == "auto" || name == "scalar" ? &SCALAR_KERNELS : nullptr;
+}
+
+// Kernels in use, the best ones of the CPU unless an instruction set was selected
+static std::atomic<const Kernels *> kernels{findKernels("auto")};
+
+// Selects the kernels of an instruction set
+bool VectorLoop::useInstructionSet(const std::string &name) {
+    const Kernels *found = findKernels(name);
+
+    if (found) {
+        kernels.store(found, std::memory_order_relaxed);
+    }
+    return found != nullptr;
+}
+
+// Returns the name of the instruction set of the kernels in use
+const char *VectorLoop::instructionSet() {
+    return kernels.load(std::memory_order_relaxed)->name;
+}
+
+// Checks if the variable in a slot is a declared array of the given type
+static bool isArrayOf(SymbolMap &symbolMap, int slot, Type type) {
+    if (!symbolMap.isDeclared(slot)) {
+        return false;
+    }
+
+    const Variable &variable = symbolMap.getVariable(slot);
+    return variable.isArray && variable.type == type;
+}
+
+// Bounds the iterations by the arrays and the initialized elements, then runs them strip by strip
+void VectorLoop::run(SymbolMap &symbolMap) const {
+    int start = symbolMap.value(counter);
+    long long end = (long long) (bound < 0 ? boundValue : symbolMap.value(bound)) + (inclusive ? 1 : 0);
+
+    // A negative index fails on the first access, left to the loop
+    if (start < 0) {
+        return;
+    }
+
+    for (int slot : intArrays) {
+        if (!isArrayOf(symbolMap, slot, Type::INT)) {
+            return;
+        }
+        end = std::min<long long>(end, symbolMap.getArray(slot).size());
+    }
+    for (int slot : boolArrays) {
+        if (!isArrayOf(symbolMap, slot, Type::BOOL)) {
+            return;
+        }
+        end = std::min<long long>(end, symbolMap.getArray(slot).size());
+    }
+    for (int slot : reads) {
+        if (end > start) {
+            end = symbolMap.getArray(slot).firstUninitialized(start, (int) end);
+        }
+    }
+
+    // A few iterations are faster on the loop itself
+    int stop = (int) end;
+    if (end - start < 8) {
+        return;
+    }
+
+    // The invariant temporaries are filled once, the others point to the strip being run
+    alignas(32) int32_t buffers[MAX_TEMPORARIES][STRIP];
+    const int32_t *temporary[MAX_TEMPORARIES] = {};
+
+    for (const Operation &operation : code) {
+        if (operation.op == Op::SCALAR || operation.op == Op::CONSTANT) {
+            int value = operation.op == Op::SCALAR ? symbolMap.value(operation.b) : operation.b;
+
+            std::fill(buffers[operation.a], buffers[operation.a] + STRIP, value);
+            temporary[operation.a] = buffers[operation.a];
+        }
+    }
+
+    // The first strip ends on a multiple of STRIP, the next ones are aligned
+    for (int index = start; index < stop;) {
+        int count = std::min(stop - index, STRIP - index % STRIP);
+
+        runStrip(symbolMap, index, count, temporary, buffers);
+        index += count;
+    }
+
+    for (const Operation &operation : code) {
+        if (operation.op == Op::STORE || operation.op == Op::STORE_BOOL) {
+            symbolMap.getArray(operation.a).markInitialized(start, stop);
+        }
+    }
+
+    symbolMap.value(counter) = stop;
+}
+
+// Runs the operations of the iterations [index, index + count) one after the other
+void VectorLoop::runStrip(SymbolMap &symbolMap, int index, int count, const int32_t **temporary, int32_t (*buffers)[STRIP]) const {
+    const Kernels &selected = *kernels.load(std::memory_order_relaxed);
+    int32_t *out[MAX_TEMPORARIES];
+
+    // A temporary stored in an integer array is computed straight into its elements
+    for (int t = 0; t < temporaries; t++) {
+        out[t] = buffers[t];
+    }
+    for (const Operation &operation : code) {
+        if (operation.op == Op::STORE && operation.c == 1) {
+            out[operation.b] = symbolMap.getArray(operation.a).intData() + index;
+        }
+    }
+
+    for (const Operation &operation : code) {
+        switch (operation.op) {
+            case Op::ELEMENT:
+                temporary[operation.a] = symbolMap.getArray(operation.b).intData() + index;
+                break;
+            case Op::SCALAR:
+            case Op::CONSTANT:
+                break;
+            case Op::COUNTER:
+                for (int i = 0; i < count; i++) {
+                    buffers[operation.a][i] = index + i;
+                }
+                temporary[operation.a] = buffers[operation.a];
+                break;
+            case Op::ADD:
+            case Op::SUB:
+            case Op::MUL:
+            case Op::EQ:
+            case Op::NEQ:
+            case Op::LESS:
+            case Op::LESSEQ:
+            case Op::GREATER:
+            case Op::GREATEREQ:
+                selected.binary[(int) operation.op - (int) Op::ADD](temporary[operation.b], temporary[operation.c], out[operation.a], count);
+                temporary[operation.a] = out[operation.a];
+                break;
+            case Op::STORE: {
+                int32_t *elements = symbolMap.getArray(operation.a).intData() + index;
+
+                if (temporary[operation.b] != elements) {
+                    std::memcpy(elements, temporary[operation.b], sizeof(int32_t) * count);
+                }
+                break;
+            }
+            case Op::STORE_BOOL: {
+                // Whole words are packed at once, the bits of the words shared with other strips one by one
+                uint64_t *words = symbolMap.getArray(operation.a).boolData();
+                const int32_t *bits = temporary[operation.b];
+
+                for (int i = 0; i < count;) {
+                    int element = index + i;
+
+                    if (element % 64 == 0 && count - i >= 64) {
+                        words[element / 64] = selected.pack(bits + i);
+                        i += 64;
+                    } else {
+                        uint64_t mask = uint64_t(1) << (element % 64);
+                        words[element / 64] = bits[i] ? words[element / 64] | mask : words[element / 64] & ~mask;
+                        i++;
+                    }
+                }
+                break;
+            }
+            case Op::SUM: {
+                uint32_t sum = selected.sum(temporary[operation.b], count);
+                uint32_t value = (uint32_t) symbolMap.value(operation.a);
+
+                symbolMap.value(operation.a) = (int) (operation.c == 1 ? value - sum : value + sum);
+                break;
+            }
+        }
+    }
+}
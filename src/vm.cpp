@@ -0,0 +1,303 @@
+// File created by fob
+
+#include "../include/vm.h"
+#include "../include/vectorloop.h"
+
+#include <typeinfo>
+
+// Throws a runtime error with the provided error message specifying line and column of the source node
+void VM::throwError(const std::string &message, const Chunk &chunk, size_t pc) {
+    Node *node = chunk.nodes[pc];
+    std::string errMsg = "Error: " + message + " at line: " + std::to_string(node->line) + " column: " + std::to_string(node->column) + " type " + typeid(node).name();
+    throw std::runtime_error(errMsg);
+}
+
+// Executes an access, a declaration or a print, as documented in bytecode.h (inlined into the loop of run)
+static inline void executeAccess(const Chunk &chunk, size_t pc, SymbolMap &symbolMap, int *r, OutputSink &output) {
+    const Instruction &instruction = chunk.code[pc];
+
+    switch (instruction.op) {
+        case OpCode::LOAD_VAR:
+            if (!symbolMap.getVariable(instruction.b).initialized) {
+                VM::throwError(uninitializedMessage(chunk.variables[instruction.b]), chunk, pc);
+            }
+
+            r[instruction.a] = symbolMap.value(instruction.b);
+            break;
+        case OpCode::LOAD_ELEM:
+        case OpCode::LOAD_ELEM_FAST: {
+            ArrayStorage &array = symbolMap.getArray(instruction.b);
+            int index = r[instruction.c];
+
+            if (instruction.op == OpCode::LOAD_ELEM && (index < 0 || index >= array.size())) {
+                VM::throwError(outOfBoundsMessage(index, array.size()), chunk, pc);
+            }
+
+            if (!array.isInitialized(index)) {
+                VM::throwError(uninitializedElementMessage(chunk.variables[instruction.b], index), chunk, pc);
+            }
+
+            r[instruction.a] = array.load(index);
+            break;
+        }
+        case OpCode::STORE_VAR:
+            symbolMap.getVariable(instruction.a).initialized = true;
+            symbolMap.value(instruction.a) = r[instruction.b];
+            break;
+        case OpCode::STORE_ELEM:
+        case OpCode::STORE_ELEM_FAST: {
+            ArrayStorage &array = symbolMap.getArray(instruction.a);
+            int index = r[instruction.b];
+
+            if (instruction.op == OpCode::STORE_ELEM && (index < 0 || index >= array.size())) {
+                VM::throwError(outOfBoundsMessage(index, array.size()), chunk, pc);
+            }
+
+            array.store(index, r[instruction.c]);
+            break;
+        }
+        case OpCode::ADD_ELEM:
+        case OpCode::ADD_ELEM_FAST: {
+            ArrayStorage &array = symbolMap.getArray(instruction.a);
+            int index = r[instruction.b];
+
+            if (instruction.op == OpCode::ADD_ELEM && (index < 0 || index >= array.size())) {
+                VM::throwError(outOfBoundsMessage(index, array.size()), chunk, pc);
+            }
+
+            if (!array.isInitialized(index)) {
+                VM::throwError(uninitializedElementMessage(chunk.variables[instruction.a], index), chunk, pc);
+            }
+
+            array.store(index, wrapAdd(array.load(index), r[instruction.c]));
+            break;
+        }
+        case OpCode::VECTOR_LOOP:
+            static_cast<WhileNode *>(chunk.nodes[pc])->vector->run(symbolMap);
+            break;
+        case OpCode::CHECK_DECLARED:
+            symbolMap.getVariable(instruction.a);
+            break;
+        case OpCode::DECLARE: {
+            Type type = instruction.b == 0 ? Type::INT : Type::BOOL;
+            symbolMap.declareVariable(instruction.a, type, instruction.c >= 0, instruction.c);
+            break;
+        }
+        case OpCode::PRINT:
+            if (instruction.b == 0) {
+                output.printInt(r[instruction.a]);
+            } else {
+                output.printBool(r[instruction.a]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Constructor: PRINT instructions write to the given sink
+VM::VM(OutputSink &output) : output(output) {}
+
+// Executes the chunk, each instruction reads and writes registers and variables as documented in bytecode.h
+void VM::run(const Chunk &chunk) {
+    symbolMap.reset(chunk.variables);
+    registers.assign(chunk.registerCount, 0);
+
+    const Instruction *code = chunk.code.data();
+    int *r = registers.data();
+    size_t pc = 0;
+
+    for (;;) {
+        const Instruction &instruction = code[pc];
+
+        switch (instruction.op) {
+            case OpCode::LOAD_INT:
+                r[instruction.a] = instruction.b;
+                break;
+            case OpCode::LOAD_BOOL:
+                r[instruction.a] = instruction.b != 0;
+                break;
+            case OpCode::LOAD_VAR_FAST:
+                r[instruction.a] = symbolMap.value(instruction.b);
+                break;
+            case OpCode::STORE_VAR_FAST:
+                symbolMap.value(instruction.a) = r[instruction.b];
+                break;
+            case OpCode::INC_VAR:
+                symbolMap.value(instruction.a) = wrapAdd(symbolMap.value(instruction.a), instruction.b);
+                break;
+            // Checked accesses, declarations and prints
+            case OpCode::LOAD_VAR:
+            case OpCode::LOAD_ELEM:
+            case OpCode::LOAD_ELEM_FAST:
+            case OpCode::STORE_VAR:
+            case OpCode::STORE_ELEM:
+            case OpCode::STORE_ELEM_FAST:
+            case OpCode::ADD_ELEM:
+            case OpCode::ADD_ELEM_FAST:
+            case OpCode::VECTOR_LOOP:
+            case OpCode::CHECK_DECLARED:
+            case OpCode::DECLARE:
+            case OpCode::PRINT:
+                executeAccess(chunk, pc, symbolMap, r, output);
+                break;
+            case OpCode::ADD:
+                r[instruction.a] = wrapAdd(r[instruction.b], r[instruction.c]);
+                break;
+            case OpCode::SUB:
+                r[instruction.a] = wrapSub(r[instruction.b], r[instruction.c]);
+                break;
+            case OpCode::MUL:
+                r[instruction.a] = wrapMul(r[instruction.b], r[instruction.c]);
+                break;
+            case OpCode::DIV:
+                if (r[instruction.c] == 0) {
+                    throwError("Impossible dividing by 0", chunk, pc);
+                }
+                r[instruction.a] = wrapDiv(r[instruction.b], r[instruction.c]);
+                break;
+            case OpCode::ADD_BOOL:
+                r[instruction.a] = r[instruction.b] | r[instruction.c];
+                break;
+            case OpCode::SUB_BOOL:
+                r[instruction.a] = r[instruction.b] ^ r[instruction.c];
+                break;
+            case OpCode::MUL_BOOL:
+                r[instruction.a] = r[instruction.b] & r[instruction.c];
+                break;
+            case OpCode::DIV_BOOL:
+                if (r[instruction.c] == 0) {
+                    throwError("Impossible dividing by 0", chunk, pc);
+                }
+                r[instruction.a] = r[instruction.b];
+                break;
+            case OpCode::EQ:
+                r[instruction.a] = r[instruction.b] == r[instruction.c];
+                break;
+            case OpCode::NEQ:
+                r[instruction.a] = r[instruction.b] != r[instruction.c];
+                break;
+            case OpCode::LESS:
+                r[instruction.a] = r[instruction.b] < r[instruction.c];
+                break;
+            case OpCode::LESSEQ:
+                r[instruction.a] = r[instruction.b] <= r[instruction.c];
+                break;
+            case OpCode::GREATER:
+                r[instruction.a] = r[instruction.b] > r[instruction.c];
+                break;
+            case OpCode::GREATEREQ:
+                r[instruction.a] = r[instruction.b] >= r[instruction.c];
+                break;
+            case OpCode::NOT:
+                r[instruction.a] = !r[instruction.b];
+                break;
+            case OpCode::NEG:
+                r[instruction.a] = wrapNeg(r[instruction.b]);
+                break;
+            case OpCode::TO_BOOL:
+                r[instruction.a] = r[instruction.b] != 0;
+                break;
+            case OpCode::JUMP:
+                pc = instruction.a;
+                continue;
+            case OpCode::JUMP_IF_FALSE:
+                if (!r[instruction.a]) {
+                    pc = instruction.b;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_TRUE:
+                if (r[instruction.a]) {
+                    pc = instruction.b;
+                    continue;
+                }
+                break;
+            // Fused compare and branch on variables
+            case OpCode::JUMP_IF_LESS:
+                if (symbolMap.value(instruction.a) < symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_LESSEQ:
+                if (symbolMap.value(instruction.a) <= symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_GREATER:
+                if (symbolMap.value(instruction.a) > symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_GREATEREQ:
+                if (symbolMap.value(instruction.a) >= symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_EQ:
+                if (symbolMap.value(instruction.a) == symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_NEQ:
+                if (symbolMap.value(instruction.a) != symbolMap.value(instruction.b)) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            // Fused compare and branch on a variable and a literal
+            case OpCode::JUMP_IF_LESS_INT:
+                if (symbolMap.value(instruction.a) < instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_LESSEQ_INT:
+                if (symbolMap.value(instruction.a) <= instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_GREATER_INT:
+                if (symbolMap.value(instruction.a) > instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_GREATEREQ_INT:
+                if (symbolMap.value(instruction.a) >= instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_EQ_INT:
+                if (symbolMap.value(instruction.a) == instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::JUMP_IF_NEQ_INT:
+                if (symbolMap.value(instruction.a) != instruction.b) {
+                    pc = instruction.c;
+                    continue;
+                }
+                break;
+            case OpCode::BREAK:
+                throw Interpreter::BreakException();
+            case OpCode::HALT:
+                return;
+        }
+
+        pc++;
+    }
+}
+
+// Executes an access, a declaration or a print for the slow path of the JIT
+void VM::execute(const Chunk &chunk, size_t pc, SymbolMap &symbolMap, int *r, OutputSink &output) {
+    executeAccess(chunk, pc, symbolMap, r, output);
+}
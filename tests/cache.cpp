@@ -0,0 +1,194 @@
+// File created by fob
+
+#include "../include/cache.h"
+#include "../include/program.h"
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// iec_cache_test checks the ProgramCache on the programs given on the command line. Each program is copied
+// into a work directory and cached next to the copy, then:
+// - a program loaded from its cache file prints the same text, raises the same error and dumps the same
+//   tree as the program built from its source, on every engine
+// - a missing, stale (the source changed), truncated or older (another version) cache file is not loaded,
+//   and the next build from the file writes a valid one again
+// - flipping any byte of the file makes it unusable (the hashes reject it)
+// - flipping any byte of the payload and fixing its hash, so the damage reaches the decoder, never crashes
+//   the load: the file is rejected or decodes to a tree
+//
+//   iec_cache_test <work directory> <file.iec>...
+
+// Offsets of the fields of ProgramCache::Header, which the test damages on purpose
+static constexpr size_t VERSION_OFFSET = 4;
+static constexpr size_t PAYLOAD_HASH_OFFSET = 24;
+static constexpr size_t HEADER_SIZE = 40;
+
+static int failures = 0;
+
+// Reports a failed check
+static void check(bool condition, const std::string &program, const std::string &message) {
+    if (!condition) {
+        std::cerr << program << ": " << message << std::endl;
+        failures++;
+    }
+}
+
+// Returns the bytes of a file
+static std::string readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream bytes;
+
+    bytes << file.rdbuf();
+    return bytes.str();
+}
+
+// Replaces the bytes of a file
+static void writeFile(const std::string &path, const std::string &bytes) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    file.write(bytes.data(), (std::streamsize) bytes.size());
+}
+
+// Returns the 64-bit FNV-1a hash of some bytes, the hash of the cache files
+static uint64_t fnv1a(const std::string &bytes, size_t from) {
+    uint64_t value = 0xcbf29ce484222325ULL;
+
+    for (size_t i = from; i < bytes.size(); i++) {
+        value = (value ^ (unsigned char) bytes[i]) * 0x100000001b3ULL;
+    }
+    return value;
+}
+
+// Returns what a program prints on an engine, followed by the message of its runtime error if any
+static std::string runOn(const Program &program, Program::Engine engine) {
+    std::ostringstream text;
+
+    try {
+        OutputSink output(text, OutputSink::FlushPolicy::EXIT);
+
+        program.run(output, engine);
+    } catch (const std::exception &e) {
+        text << e.what() << "\n";
+    }
+    return text.str();
+}
+
+// Returns the printed tree of a program
+static std::string dump(const Program &program) {
+    std::ostringstream text;
+
+    text << program.tree();
+    return text.str();
+}
+
+// Checks whether the cache file of a source can be loaded
+static bool loads(const ProgramCache &cache, const std::string &path) {
+    std::string source = readFile(path);
+    Arena arena;
+
+    return cache.load(path, source, arena) != nullptr;
+}
+
+// Runs every check on a program
+static void testProgram(const std::string &original, const std::filesystem::path &work) {
+    const Program::Engine engines[] = {Program::Engine::INTERPRETER, Program::Engine::VM, Program::Engine::JIT};
+    std::string name = std::filesystem::path(original).filename().string();
+    std::string path = (work / name).string();
+    std::string cachePath = path + ".iecc";
+    ProgramCache cache;
+
+    std::filesystem::remove(cachePath);
+    std::filesystem::copy_file(original, path, std::filesystem::copy_options::overwrite_existing);
+
+    Program reference = Program::fromSource(readFile(path));
+    check(!loads(cache, path), name, "a missing cache file was loaded");
+
+    // The first build writes the cache file, the next ones load it
+    Program::fromFile(path, &cache);
+    check(loads(cache, path), name, "the cache file written by a build cannot be loaded");
+
+    Program cached = Program::fromFile(path, &cache);
+    check(dump(cached) == dump(reference), name, "the cached tree differs from the tree built from the source");
+    for (Program::Engine engine : engines) {
+        check(runOn(cached, engine) == runOn(reference, engine), name,
+              "the cached program runs differently on engine " + std::to_string((int) engine));
+    }
+
+    std::string good = readFile(cachePath);
+    check(good.size() > HEADER_SIZE, name, "the cache file has no payload");
+
+    // Each damaged file is rejected, and a build from the source writes the valid one back
+    auto rejected = [&](const std::string &bytes, const std::string &damage) {
+        writeFile(cachePath, bytes);
+        check(!loads(cache, path), name, "a " + damage + " cache file was loaded");
+
+        Program rebuilt = Program::fromFile(path, &cache);
+        check(runOn(rebuilt, Program::Engine::VM) == runOn(reference, Program::Engine::VM), name,
+              "the program rebuilt after a " + damage + " cache file runs differently");
+        check(readFile(cachePath) == good, name, "a " + damage + " cache file was not rewritten");
+    };
+
+    rejected(good.substr(0, good.size() / 2), "truncated");
+    rejected(good.substr(0, HEADER_SIZE - 1), "headless");
+
+    std::string older = good;
+    older[VERSION_OFFSET] = (char) (older[VERSION_OFFSET] - 1);
+    rejected(older, "older version");
+
+    for (size_t i = 0; i < good.size(); i++) {
+        std::string flipped = good;
+        flipped[i] = (char) (flipped[i] ^ 0x20);
+        writeFile(cachePath, flipped);
+        check(!loads(cache, path), name, "a cache file with byte " + std::to_string(i) + " flipped was loaded");
+    }
+
+    // Damage reaching the decoder: it may reject the payload or decode another tree, but must not crash
+    for (size_t i = HEADER_SIZE; i < good.size(); i++) {
+        for (uint8_t mask : {0x01, 0x80, 0xFF}) {
+            std::string damaged = good;
+            damaged[i] = (char) (damaged[i] ^ mask);
+
+            uint64_t payloadHash = fnv1a(damaged, HEADER_SIZE);
+            std::memcpy(&damaged[PAYLOAD_HASH_OFFSET], &payloadHash, sizeof(payloadHash));
+            writeFile(cachePath, damaged);
+            loads(cache, path);
+        }
+    }
+    writeFile(cachePath, good);
+
+    // A stale cache file: the source changed, so the new source runs and its tree is cached
+    writeFile(path, readFile(path) + "\n");
+    check(!loads(cache, path), name, "the cache file of a changed source was loaded");
+
+    writeFile(path, "{\n    print(42);\n}\n");
+    Program changed = Program::fromFile(path, &cache);
+    check(runOn(changed, Program::Engine::INTERPRETER) == "42\n", name, "a stale cache file was run instead of the new source");
+    check(loads(cache, path), name, "the cache file of the new source was not written");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::cerr << "Error: Usage: iec_cache_test <work directory> <file.iec>..." << std::endl;
+        return 1;
+    }
+
+    try {
+        std::filesystem::path work = argv[1];
+        std::filesystem::create_directories(work);
+
+        for (int i = 2; i < argc; i++) {
+            testProgram(argv[i], work);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
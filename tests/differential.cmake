@@ -0,0 +1,62 @@
+# File created by fob
+
+# Runs a program on every engine and checks that they print the same text and raise the same error.
+# The tree-walking interpreter (with the plain C++ kernels of the vectorized loops) is the reference,
+# the VM and the JIT run with each instruction set of the kernels this machine supports.
+# When EXPECTED names a file, the reference output must also match it.
+#
+#   cmake -DIEC=<iec> -DPROGRAM=<file.iec> [-DEXPECTED=<file.out>] -P differential.cmake
+
+if(NOT IEC OR NOT PROGRAM)
+    message(FATAL_ERROR "Usage: cmake -DIEC=<iec> -DPROGRAM=<file.iec> [-DEXPECTED=<file.out>] -P differential.cmake")
+endif()
+
+# Runs iec with the given options on the program, the results go to <prefix>_OUT, _ERR and _CODE
+function(run_iec prefix)
+    execute_process(COMMAND ${IEC} ${ARGN} ${PROGRAM}
+        OUTPUT_VARIABLE out ERROR_VARIABLE err RESULT_VARIABLE code)
+    set(${prefix}_OUT "${out}" PARENT_SCOPE)
+    set(${prefix}_ERR "${err}" PARENT_SCOPE)
+    set(${prefix}_CODE "${code}" PARENT_SCOPE)
+endfunction()
+
+run_iec(REFERENCE --simd=scalar)
+
+if(EXPECTED)
+    file(READ ${EXPECTED} expected)
+    if(NOT "${REFERENCE_OUT}${REFERENCE_ERR}" STREQUAL "${expected}")
+        message(FATAL_ERROR "${PROGRAM}: the interpreter printed\n${REFERENCE_OUT}${REFERENCE_ERR}\ninstead of\n${expected}")
+    endif()
+endif()
+
+set(failures 0)
+foreach(isa scalar sse4.1 avx2)
+    foreach(engine interpreter --vm --jit)
+        if(engine STREQUAL "interpreter")
+            set(flags --simd=${isa})
+        else()
+            set(flags ${engine} --simd=${isa})
+        endif()
+
+        run_iec(RUN ${flags})
+        string(REPLACE ";" " " shown "${flags}")
+
+        # An instruction set missing on this machine is rejected before running, it is skipped
+        if(RUN_ERR MATCHES "is not available on this machine")
+            continue()
+        endif()
+
+        if(NOT "${RUN_OUT}" STREQUAL "${REFERENCE_OUT}")
+            message(SEND_ERROR "${PROGRAM}: stdout of ${shown} differs from the interpreter:\n${RUN_OUT}")
+            math(EXPR failures "${failures} + 1")
+        endif()
+        if(NOT "${RUN_ERR}" STREQUAL "${REFERENCE_ERR}" OR NOT "${RUN_CODE}" STREQUAL "${REFERENCE_CODE}")
+            message(SEND_ERROR "${PROGRAM}: stderr or exit status of ${shown} differs from the interpreter:\n${RUN_ERR}(status ${RUN_CODE})")
+            math(EXPR failures "${failures} + 1")
+        endif()
+    endforeach()
+endforeach()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${PROGRAM}: ${failures} engine runs differ from the interpreter")
+endif()
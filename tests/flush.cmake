@@ -0,0 +1,39 @@
+# File created by fob
+
+# Runs a program with every flush policy and checks that they print the same text and raise the
+# same error: the policies only change when the printed text reaches stdout, never what is printed.
+# Each engine is checked, the default block policy being the reference.
+#
+#   cmake -DIEC=<iec> -DPROGRAM=<file.iec> -P flush.cmake
+
+if(NOT IEC OR NOT PROGRAM)
+    message(FATAL_ERROR "Usage: cmake -DIEC=<iec> -DPROGRAM=<file.iec> -P flush.cmake")
+endif()
+
+set(failures 0)
+foreach(engine interpreter --vm --jit)
+    if(engine STREQUAL "interpreter")
+        set(engine "")
+    endif()
+
+    execute_process(COMMAND ${IEC} ${engine} --flush=block ${PROGRAM}
+        OUTPUT_VARIABLE reference ERROR_VARIABLE referenceErr RESULT_VARIABLE referenceCode)
+
+    foreach(policy line exit)
+        execute_process(COMMAND ${IEC} ${engine} --flush=${policy} ${PROGRAM}
+            OUTPUT_VARIABLE out ERROR_VARIABLE err RESULT_VARIABLE code)
+
+        if(NOT "${out}" STREQUAL "${reference}")
+            message(SEND_ERROR "${PROGRAM}: stdout of ${engine} --flush=${policy} differs from --flush=block")
+            math(EXPR failures "${failures} + 1")
+        endif()
+        if(NOT "${err}" STREQUAL "${referenceErr}" OR NOT "${code}" STREQUAL "${referenceCode}")
+            message(SEND_ERROR "${PROGRAM}: stderr or exit status of ${engine} --flush=${policy} differs from --flush=block:\n${err}(status ${code})")
+            math(EXPR failures "${failures} + 1")
+        endif()
+    endforeach()
+endforeach()
+
+if(failures GREATER 0)
+    message(FATAL_ERROR "${PROGRAM}: ${failures} runs differ from --flush=block")
+endif()
@@ -0,0 +1,21 @@
+# File created by fob
+
+# Generates a program with iec_gen from a seed, then checks that the engines agree on it as
+# differential.cmake does. The seed makes the program, and so any reported difference, reproducible.
+#
+#   cmake -DIEC=<iec> -DIEC_GEN=<iec_gen> -DSEED=<n> -DPROGRAM=<file.iec> -P generated.cmake
+
+if(NOT IEC OR NOT IEC_GEN OR NOT DEFINED SEED OR NOT PROGRAM)
+    message(FATAL_ERROR "Usage: cmake -DIEC=<iec> -DIEC_GEN=<iec_gen> -DSEED=<n> -DPROGRAM=<file.iec> -P generated.cmake")
+endif()
+
+get_filename_component(directory ${PROGRAM} DIRECTORY)
+file(MAKE_DIRECTORY ${directory})
+
+execute_process(COMMAND ${IEC_GEN} --seed=${SEED} --statements=300 --depth=4 --output=${PROGRAM}
+    ERROR_VARIABLE err RESULT_VARIABLE code)
+if(NOT code EQUAL 0)
+    message(FATAL_ERROR "iec_gen --seed=${SEED} failed:\n${err}")
+endif()
+
+include(${CMAKE_CURRENT_LIST_DIR}/differential.cmake)